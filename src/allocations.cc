@@ -0,0 +1,172 @@
+/*
+ * allocations.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include <new>
+#include <atomic>
+#include "allocations.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::counters
+// ---------------------------------------------------------------------------
+
+namespace {
+
+std::atomic<uint64_t> allocation_count(0);
+std::atomic<uint64_t> allocation_bytes(0);
+
+}
+
+// ---------------------------------------------------------------------------
+// Allocations
+// ---------------------------------------------------------------------------
+
+auto Allocations::enabled() -> bool
+{
+#ifdef ALLOC_COUNTER
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto Allocations::count() -> uint64_t
+{
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+auto Allocations::bytes() -> uint64_t
+{
+    return allocation_bytes.load(std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------
+// global operator new/delete
+// ---------------------------------------------------------------------------
+
+#ifdef ALLOC_COUNTER
+
+namespace {
+
+/*
+ * as the standard allocation functions do, call the installed new-handler
+ * until the allocation succeeds, and throw only when there is none left
+ */
+
+inline auto allocate(size_t size) -> void*
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    void* pointer = ::malloc(size != 0 ? size : 1);
+
+    while(pointer == nullptr) {
+        const std::new_handler handler = std::get_new_handler();
+        if(handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+        pointer = ::malloc(size != 0 ? size : 1);
+    }
+    return pointer;
+}
+
+inline auto allocate_nothrow(size_t size) noexcept -> void*
+{
+    try {
+        return allocate(size);
+    }
+    catch(const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+}
+
+void* operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate_nothrow(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate_nothrow(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    ::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    ::free(pointer);
+}
+
+#endif
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,42 @@
+/*
+ * allocations.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Allocations_h__
+#define __Allocations_h__
+
+// ---------------------------------------------------------------------------
+// Allocations
+//
+// counters maintained by the replacements of the global operator new and
+// operator delete, used to check the zero-allocation steady state. The
+// replacements are only compiled when ALLOC_COUNTER is defined, otherwise
+// the counters stay at zero.
+// ---------------------------------------------------------------------------
+
+struct Allocations
+{
+    static auto enabled() -> bool;
+
+    static auto count() -> uint64_t;
+
+    static auto bytes() -> uint64_t;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Allocations_h__ */
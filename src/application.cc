@@ -34,6 +34,8 @@
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
+#include "globals.h"
+#include "allocations.h"
 #include "application.h"
 
 // ---------------------------------------------------------------------------
@@ -42,6 +44,12 @@
 
 namespace {
 
+constexpr size_t   arena_capacity = (1024 * 1024);
+constexpr uint64_t warmup_frames  = 120;
+constexpr double   spin_margin    = 0.002;
+constexpr int      idle_timeout   = 100;
+constexpr int      default_rate   = 60;
+
 inline auto clampf(float val, float min, float max) -> float
 {
     if(val < min) {
@@ -61,20 +69,46 @@ inline auto clampf(float val, float min, float max) -> float
 
 Application::Application(const std::string& title)
     : _title(title)
+    , _frequency(0)
     , _ptime(0)
     , _ctime(0)
     , _dtime(0.0f)
     , _quit(false)
+    , _idle(false)
+    , _arena(arena_capacity)
+    , _frame(0)
+    , _frame_allocs(0)
+    , _deadline(0)
+    , _refresh_rate(default_rate)
+    , _stats_time(0)
+    , _stats_frames(0)
+    , _stats_allocs(0)
+    , _stats_allocs_max(0)
+    , _stats_pacing_sum(0)
+    , _stats_pacing_max(0)
+    , _stats_idle(0)
 {
-    constexpr uint32_t flags = SDL_INIT_VIDEO | SDL_INIT_AUDIO;
+    const uint32_t flags = (Globals::headless != false ? 0 : SDL_INIT_VIDEO | SDL_INIT_AUDIO);
 
+    if((Globals::alloc_assert != false) && (Allocations::enabled() == false)) {
+        throw std::runtime_error("--alloc-assert requires a build with ALLOC_COUNTER defined");
+    }
     if(::SDL_Init(flags) != 0) {
         throw std::runtime_error("SDL_Init() has failed");
     }
     else {
-        _ptime  = ::SDL_GetTicks();
-        _ctime  = ::SDL_GetTicks();
-        _dtime  = ::clampf((float(_ctime - _ptime) / 1000.0f), 0.0f, 0.1f);
+        _frequency  = ::SDL_GetPerformanceFrequency();
+        _ptime      = ::SDL_GetPerformanceCounter();
+        _ctime      = _ptime;
+        _dtime      = 0.0f;
+        _deadline   = _ctime;
+        _stats_time = _ctime;
+    }
+    if(Globals::headless == false) {
+        SDL_DisplayMode mode;
+        if((::SDL_GetCurrentDisplayMode(0, &mode) == 0) && (mode.refresh_rate > 0)) {
+            _refresh_rate = mode.refresh_rate;
+        }
     }
 }
 
@@ -85,27 +119,83 @@ Application::~Application()
 
 void Application::loop()
 {
+    auto seconds = [&](uint64_t ticks) -> double
+    {
+        return double(ticks) / double(_frequency);
+    };
+
     auto get_ticks = [&]() -> bool
     {
-        const uint32_t ptime = _ctime;
-        const uint32_t ctime = ::SDL_GetTicks();
-        const bool     valid = (ctime != ptime);
-
-        if(valid != false) {
-            _ptime = ptime;
-            _ctime = ctime;
-            _dtime = ::clampf((float(_ctime - _ptime) / 1000.0f), 0.0f, 0.1f);
+        _ptime = _ctime;
+        _ctime = ::SDL_GetPerformanceCounter();
+        _dtime = ::clampf(float(seconds(_ctime - _ptime)), 0.0f, 0.1f);
+
+        return true;
+    };
+
+    /*
+     * the frames are paced to the requested rate, or to the refresh rate of
+     * the display when the present mode is capped without one
+     */
+    auto pacing = [&]() -> int
+    {
+        if((Globals::pacing <= 0) && (Globals::present_mode == PresentType::CAPPED)) {
+            return _refresh_rate;
         }
-        else {
-            _dtime = 0.0f;
+        return Globals::pacing;
+    };
+
+    /*
+     * sleeps until shortly before the deadline, since the scheduler may
+     * oversleep by a millisecond or more, then spins for the remainder
+     */
+    auto wait_deadline = [&]() -> void
+    {
+        if(pacing() <= 0) {
+            return;
+        }
+        const uint64_t period = (_frequency / uint64_t(pacing()));
+        const uint64_t margin = uint64_t(spin_margin * double(_frequency));
+        uint64_t       now    = ::SDL_GetPerformanceCounter();
+
+        _deadline += period;
+        if((now > _deadline) && ((now - _deadline) > period)) {
+            _deadline = now;
         }
-        return valid;
+        if((now + margin) < _deadline) {
+            const double delay = seconds(_deadline - margin - now);
+            std::this_thread::sleep_for(std::chrono::duration<double>(delay));
+        }
+        while((now = ::SDL_GetPerformanceCounter()) < _deadline) {
+            continue;
+        }
+        const uint64_t error = (now - _deadline);
+        if(error > _stats_pacing_max) {
+            _stats_pacing_max = error;
+        }
+        _stats_pacing_sum += error;
+    };
+
+    /*
+     * while the scene is idle, blocks until an event is pending or until the
+     * timeout expires, and restarts the clock so that the scene does not
+     * take a single long step on wake-up
+     */
+    auto wait_events = [&]() -> bool
+    {
+        bool pending = true;
+#ifndef __EMSCRIPTEN__
+        pending = (::SDL_WaitEventTimeout(nullptr, idle_timeout) != 0);
+#endif
+        _ctime = ::SDL_GetPerformanceCounter();
+        return pending;
     };
 
-    auto poll_events = [&]() -> bool
+    auto poll_events = [&](uint32_t& count) -> bool
     {
         EventType event;
         while(::SDL_PollEvent(&event) != 0) {
+            ++count;
             switch(event.type) {
                 case SDL_QUIT:
                     on_quit(event.quit);
@@ -138,12 +228,88 @@ void Application::loop()
         return running();
     };
 
+    auto begin_frame = [&]() -> void
+    {
+        _arena.reset();
+        _frame_allocs = Allocations::count();
+    };
+
+    auto end_frame = [&]() -> void
+    {
+        const uint64_t allocs = (Allocations::count() - _frame_allocs);
+
+        if((Globals::alloc_assert != false) && (_frame >= warmup_frames) && (allocs != 0)) {
+            throw std::runtime_error("unexpected allocation in the steady state");
+        }
+        if(allocs > _stats_allocs_max) {
+            _stats_allocs_max = allocs;
+        }
+        _stats_allocs += allocs;
+        _stats_frames += 1;
+        _frame        += 1;
+    };
+
+    auto print_stats = [&](std::ostream& stream) -> void
+    {
+        const double elapsed = seconds(_ctime - _stats_time);
+
+        if(elapsed >= 1.0) {
+            if(Globals::stats != false) {
+                stream << "fps "           << (double(_stats_frames) / elapsed)
+                       << ", allocs/frame " << (float(_stats_allocs) / float(_stats_frames))
+                       << " (max "          << _stats_allocs_max << ")"
+                       << ", arena "        << _arena.used() << "/" << _arena.capacity()
+                       << " (high-water "   << _arena.high_water() << ")";
+                if(_stats_idle != 0) {
+                    stream << ", idle frames " << _stats_idle;
+                }
+                if(pacing() > 0) {
+                    stream << ", pacing error " << (1e6 * seconds(_stats_pacing_sum) / double(_stats_frames)) << "us"
+                           << " (max "          << (1e6 * seconds(_stats_pacing_max)) << "us)";
+                }
+                stats(stream);
+                stream << std::endl;
+            }
+            _stats_time       = _ctime;
+            _stats_frames     = 0;
+            _stats_allocs     = 0;
+            _stats_allocs_max = 0;
+            _stats_pacing_sum = 0;
+            _stats_pacing_max = 0;
+            _stats_idle       = 0;
+        }
+    };
+
+    auto skip_frame = [&]() -> void
+    {
+        ++_stats_idle;
+        get_ticks();
+        end_frame();
+        print_stats(std::cout);
+    };
+
     auto do_loop = [&]() -> void
     {
-        if(poll_events()) {
+        uint32_t events = 0;
+        begin_frame();
+        if((_idle != false) && (wait_events() == false)) {
+            return skip_frame();
+        }
+        if(poll_events(events)) {
             if(get_ticks()) {
                 update();
-                render();
+                _idle = ((Globals::idle != false) && (events == 0) && (idle() != false));
+                if(_idle != false) {
+                    ++_stats_idle;
+                }
+                else {
+                    render();
+                }
+                end_frame();
+                print_stats(std::cout);
+                if(_idle == false) {
+                    wait_deadline();
+                }
             }
         }
     };
@@ -18,6 +18,7 @@
 #define __Application_h__
 
 #include "canvas.h"
+#include "arena.h"
 
 // ---------------------------------------------------------------------------
 // Application
@@ -55,6 +56,10 @@ protected: // protected interface
 
     virtual auto shutdown() -> void = 0;
 
+    virtual auto stats(std::ostream&) -> void = 0;
+
+    virtual auto idle() -> bool = 0;
+
     virtual auto on_quit(const QuitEventType&) -> void = 0;
 
     virtual auto on_window(const WindowEventType&) -> void = 0;
@@ -73,10 +78,24 @@ protected: // protected interface
 
 protected: // protected data
     const std::string _title;
-    uint32_t          _ptime;
-    uint32_t          _ctime;
+    uint64_t          _frequency;
+    uint64_t          _ptime;
+    uint64_t          _ctime;
     float             _dtime;
     bool              _quit;
+    bool              _idle;
+    Arena             _arena;
+    uint64_t          _frame;
+    uint64_t          _frame_allocs;
+    uint64_t          _deadline;
+    int               _refresh_rate;
+    uint64_t          _stats_time;
+    uint32_t          _stats_frames;
+    uint64_t          _stats_allocs;
+    uint64_t          _stats_allocs_max;
+    uint64_t          _stats_pacing_sum;
+    uint64_t          _stats_pacing_max;
+    uint32_t          _stats_idle;
 };
 
 // ---------------------------------------------------------------------------
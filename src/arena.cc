@@ -0,0 +1,114 @@
+/*
+ * arena.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "arena.h"
+
+// ---------------------------------------------------------------------------
+// Arena
+// ---------------------------------------------------------------------------
+
+Arena::Arena(size_t capacity)
+    : _block(new uint8_t[capacity])
+    , _spills()
+    , _capacity(capacity)
+    , _offset(0)
+    , _spilled(0)
+    , _high_water(0)
+{
+}
+
+auto Arena::reset() -> void
+{
+    if(_spills.empty() == false) {
+        size_t capacity = (_capacity * 2);
+        while(capacity < _high_water) {
+            capacity *= 2;
+        }
+        _block.reset(new uint8_t[capacity]);
+        _spills.clear();
+        _capacity = capacity;
+    }
+    _offset  = 0;
+    _spilled = 0;
+}
+
+/*
+ * touches every page of the block, so that the first frames do not pay for
+ * the page faults of a freshly allocated block
+ */
+auto Arena::prefault() -> void
+{
+    ::memset(_block.get(), 0, _capacity);
+}
+
+auto Arena::allocate(size_t size, size_t alignment) -> void*
+{
+    auto spill = [&]() -> void*
+    {
+        _spills.emplace_back(new uint8_t[size + alignment]);
+        _spilled += (size + alignment);
+        if(used() > _high_water) {
+            _high_water = used();
+        }
+        const uintptr_t address = reinterpret_cast<uintptr_t>(_spills.back().get());
+        const uintptr_t aligned = ((address + (alignment - 1)) & ~uintptr_t(alignment - 1));
+
+        return reinterpret_cast<void*>(aligned);
+    };
+
+    auto bump = [&]() -> void*
+    {
+        const uintptr_t base    = reinterpret_cast<uintptr_t>(_block.get());
+        const uintptr_t address = (base + _offset);
+        const uintptr_t aligned = ((address + (alignment - 1)) & ~uintptr_t(alignment - 1));
+        const size_t    offset  = ((aligned - base) + size);
+
+        if(offset > _capacity) {
+            return spill();
+        }
+        _offset = offset;
+        if(used() > _high_water) {
+            _high_water = used();
+        }
+        return reinterpret_cast<void*>(aligned);
+    };
+
+    return bump();
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
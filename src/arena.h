@@ -0,0 +1,167 @@
+/*
+ * arena.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Arena_h__
+#define __Arena_h__
+
+// ---------------------------------------------------------------------------
+// ArenaArray
+// ---------------------------------------------------------------------------
+
+template <typename T>
+class ArenaArray
+{
+public: // public interface
+    ArenaArray()
+        : _data(nullptr)
+        , _size(0)
+        , _capacity(0)
+    {
+    }
+
+    ArenaArray(T* data, size_t capacity)
+        : _data(data)
+        , _size(0)
+        , _capacity(capacity)
+    {
+    }
+
+    auto push_back(const T& value) -> bool
+    {
+        if(_size < _capacity) {
+            _data[_size++] = value;
+            return true;
+        }
+        return false;
+    }
+
+    auto clear() -> void
+    {
+        _size = 0;
+    }
+
+    auto data() const -> T*
+    {
+        return _data;
+    }
+
+    auto size() const -> size_t
+    {
+        return _size;
+    }
+
+    auto capacity() const -> size_t
+    {
+        return _capacity;
+    }
+
+    auto empty() const -> bool
+    {
+        return _size == 0;
+    }
+
+    auto operator[](size_t index) const -> T&
+    {
+        return _data[index];
+    }
+
+public: // public iterators
+    auto begin() const -> T*
+    {
+        return _data;
+    }
+
+    auto end() const -> T*
+    {
+        return _data + _size;
+    }
+
+private: // private data
+    T*     _data;
+    size_t _size;
+    size_t _capacity;
+};
+
+// ---------------------------------------------------------------------------
+// Arena
+//
+// bump allocator for the transient data of a frame. The memory is never
+// freed individually, everything is released at once by reset(). When the
+// block is exhausted, the requests are served by spill blocks and the next
+// reset() grows the block, so that the steady state does not allocate.
+// ---------------------------------------------------------------------------
+
+class Arena
+{
+public: // public interface
+    Arena(size_t capacity);
+
+    Arena(const Arena&) = delete;
+
+    Arena& operator=(const Arena&) = delete;
+
+    virtual ~Arena() = default;
+
+    auto reset() -> void;
+
+    auto prefault() -> void;
+
+    auto allocate(size_t size, size_t alignment) -> void*;
+
+    template <typename T>
+    auto allocate(size_t count) -> T*
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+
+        return static_cast<T*>(allocate((count * sizeof(T)), alignof(T)));
+    }
+
+    template <typename T>
+    auto allocate_array(size_t capacity) -> ArenaArray<T>
+    {
+        return ArenaArray<T>(allocate<T>(capacity), capacity);
+    }
+
+public: // public accessors
+    auto used() const -> size_t
+    {
+        return _offset + _spilled;
+    }
+
+    auto capacity() const -> size_t
+    {
+        return _capacity;
+    }
+
+    auto high_water() const -> size_t
+    {
+        return _high_water;
+    }
+
+private: // private data
+    std::unique_ptr<uint8_t[]>              _block;
+    std::vector<std::unique_ptr<uint8_t[]>> _spills;
+    size_t                                  _capacity;
+    size_t                                  _offset;
+    size_t                                  _spilled;
+    size_t                                  _high_water;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Arena_h__ */
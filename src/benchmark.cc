@@ -0,0 +1,420 @@
+/*
+ * benchmark.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "globals.h"
+#include "objects.h"
+#include "raster.h"
+#include "benchmark.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::utilities
+// ---------------------------------------------------------------------------
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Function>
+auto measure(int iterations, Function&& function) -> double
+{
+    for(int iteration = 0; iteration < (iterations / 10); ++iteration) {
+        function();
+    }
+    const Clock::time_point start(Clock::now());
+    for(int iteration = 0; iteration < iterations; ++iteration) {
+        function();
+    }
+    const Clock::time_point stop(Clock::now());
+
+    return std::chrono::duration<double, std::nano>(stop - start).count() / double(iterations);
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+auto Benchmark::run(std::ostream& stream) -> void
+{
+    collide(stream);
+    fixed_point(stream);
+    raster(stream);
+}
+
+auto Benchmark::collide(std::ostream& stream) -> void
+{
+    constexpr int   iterations = 2000000;
+    constexpr int   vertices   = PolygonType::HEXAGON;
+    constexpr float radius     = 350.0f;
+    const bool      fast_math  = Globals::fast_math;
+    const Pos2f     center(0.0f, 0.0f);
+    const Pos2f     inside(0.0f, 0.0f);
+    const Pos2f     contact(0.0f, 240.0f);
+    volatile float  sink = 0.0f;
+
+    Poly poly(center, vertices, radius);
+    Ball ball(inside, 100.0f);
+
+    poly.update(0.0f);
+
+    auto collide = [&](const Pos2f& position) -> void
+    {
+        ball.set_position(position);
+        ball.set_velocity(Vec2f(0.0f, 1000.0f));
+        ball.collide(poly);
+        sink = sink + ball.position().y;
+    };
+
+    auto run_case = [&](const char* label, const Pos2f& position) -> void
+    {
+        Globals::set_fast_math(false);
+        const double precise = measure(iterations, [&]() { collide(position); });
+        Globals::set_fast_math(true);
+        const double fast = measure(iterations, [&]() { collide(position); });
+        stream << "collide/" << label << " precise ... " << precise << " ns" << std::endl;
+        stream << "collide/" << label << " fast ...... " << fast    << " ns" << std::endl;
+        stream << "collide/" << label << " saving .... " << (100.0 * (precise - fast) / precise) << " %" << std::endl;
+    };
+
+    auto max_error = [&]() -> double
+    {
+        double error = 0.0;
+        for(float value = 1e-3f; value < 1e+7f; value *= 1.001f) {
+            const Vec2f  vector(value, (0.5f * value));
+            const double expected = ::hypot(double(vector.x), double(vector.y));
+            const double relative = ::fabs(double(fast_length(vector)) - expected) / expected;
+            if(relative > error) {
+                error = relative;
+            }
+        }
+        return error;
+    };
+
+    auto run_norm = [&]() -> void
+    {
+        constexpr int count = 1024;
+        std::vector<Vec2f> vectors(count);
+        int index = 0;
+        for(auto& vector : vectors) {
+            vector = Vec2f(float(index % 97) - 48.0f, float(index % 89) - 44.0f);
+            ++index;
+        }
+        auto run_kernel = [&](const char* label, auto kernel) -> double
+        {
+            const double elapsed = measure((iterations / count), [&]()
+            {
+                Vec2f normal;
+                float total = 0.0f;
+                for(auto& vector : vectors) {
+                    total += kernel(vector, normal) + normal.x;
+                }
+                sink = sink + total;
+            });
+            stream << "norm/" << label << " ... " << (elapsed / double(count)) << " ns" << std::endl;
+            return elapsed;
+        };
+        const double separate = run_kernel("length+normalize", [](const Vec2f& vector, Vec2f& normal) -> float
+        {
+            normal = normalize(vector);
+            return length(vector);
+        });
+        const double fused = run_kernel("length_normal", [](const Vec2f& vector, Vec2f& normal) -> float
+        {
+            return length_normal(vector, normal);
+        });
+        const double fast = run_kernel("fast_length_normal", [](const Vec2f& vector, Vec2f& normal) -> float
+        {
+            return fast_length_normal(vector, normal);
+        });
+        stream << "norm/fused saving ... " << (100.0 * (separate - fused) / separate) << " %" << std::endl;
+        stream << "norm/fast saving .... " << (100.0 * (separate - fast) / separate) << " %" << std::endl;
+    };
+
+    run_norm();
+    run_case("miss", inside);
+    run_case("contact", contact);
+    stream << "fast_length max error ... " << max_error() << std::endl;
+
+    Globals::set_fast_math(fast_math);
+}
+
+auto Benchmark::fixed_point(std::ostream& stream) -> void
+{
+    constexpr int   steps       = 200000;
+    constexpr float dt          = (1.0f / 240.0f);
+    const bool      fixed_point = Globals::fixed_point;
+
+    auto checksum = [](const Object& object, uint64_t hash) -> uint64_t
+    {
+        const float values[4] = {
+            object.position().x,
+            object.position().y,
+            object.velocity().x,
+            object.velocity().y,
+        };
+        for(auto& value : values) {
+            uint32_t bits;
+            ::memcpy(&bits, &value, sizeof(bits));
+            hash = ((hash ^ bits) * UINT64_C(1099511628211));
+        }
+        return hash;
+    };
+
+    auto run_case = [&](const char* label, bool enabled) -> double
+    {
+        Poly poly(Pos2f(640.0f, 360.0f), PolygonType::HEXAGON, 350.0f);
+        Ball ball(Pos2f(640.0f, 360.0f), 100.0f);
+        poly.set_omega(2.09f);
+        ball.set_friction(Vec2f(0.25f, 0.25f));
+        ball.set_gravity(Vec2f(0.0f, GravityType::EARTH));
+        Globals::set_fixed_point(enabled);
+        const double elapsed = measure(steps, [&]()
+        {
+            poly.update(dt);
+            ball.update(dt);
+            ball.collide(poly);
+        });
+        const uint64_t hash = checksum(ball, checksum(poly, UINT64_C(14695981039346656037)));
+        stream << "physics/" << label << " ... " << elapsed << " ns/step, checksum " << std::hex << hash << std::dec << std::endl;
+        return elapsed;
+    };
+
+    const double float_path = run_case("float", false);
+    const double fixed_path = run_case("fixed", true);
+    stream << "physics/fixed vs float ... " << (fixed_path / float_path) << "x" << std::endl;
+
+    Globals::set_fixed_point(fixed_point);
+}
+
+/*
+ * draws the same recorded frame with the tile rasterizer, on one thread and
+ * on all of them, and with the software renderer of SDL into a surface
+ */
+auto Benchmark::raster(std::ostream& stream) -> void
+{
+    constexpr int      frames    = 100;
+    constexpr int      width     = 1280;
+    constexpr int      height    = 720;
+    constexpr int      balls     = 1000;
+    constexpr int      particles = 4096;
+    constexpr uint32_t colors[4] = { 0xff4040ff, 0x40ff40ff, 0x4040ffff, 0xffff40ff };
+    const int          threads   = std::max(1, ::SDL_GetCPUCount());
+    volatile uint32_t  sink      = 0;
+
+    std::vector<Shape>            shapes;
+    std::vector<VertexType>       vertices;
+    std::vector<int>              indices;
+    std::vector<RectType>         rects;
+    std::vector<DrawCommand>      commands;
+    std::vector<uint32_t>         pixels(width * height);
+    std::unique_ptr<SurfaceType>  surface(::SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888));
+    std::unique_ptr<RendererType> renderer(bool(surface) != false ? ::SDL_CreateSoftwareRenderer(surface.get()) : nullptr);
+    SpriteCache                   sprites;
+
+    if(bool(renderer) != false) {
+        sprites.create(renderer.get());
+    }
+
+    auto add_command = [&](int type, uint32_t color, int first, int count) -> void
+    {
+        commands.push_back(DrawCommand{type, color, first, count, int(commands.size())});
+    };
+
+    auto add_polygon = [&]() -> void
+    {
+        for(int index = 0; index < 6; ++index) {
+            const float angle0 = (2.0f * float(M_PI) * float(index + 0) / 6.0f);
+            const float angle1 = (2.0f * float(M_PI) * float(index + 1) / 6.0f);
+            shapes.push_back(Shape{(640.0f + (350.0f * ::cosf(angle0))), (360.0f + (350.0f * ::sinf(angle0))), (640.0f + (350.0f * ::cosf(angle1))), (360.0f + (350.0f * ::sinf(angle1))), 0.5f});
+        }
+        add_command(DrawType::LINES, 0xffffffff, 0, int(shapes.size()));
+    };
+
+    auto add_ball = [&](int index, uint32_t color) -> void
+    {
+        const SDL_Color white  = { 255, 255, 255, 255 };
+        const int       radius = (8 + ((index % 4) * 4));
+        const float     xc     = float(20 + ((index * 397) % (width  - 40)));
+        const float     yc     = float(20 + ((index * 631) % (height - 40)));
+        const float     extent = float(radius + 1);
+        const Sprite*   sprite = (bool(renderer) != false ? sprites.find(radius, color, 0) : nullptr);
+        const float     scale  = (1.0f / 1024.0f);
+        const float     u0     = (sprite != nullptr ? float(sprite->cell.x) * scale : 0.0f);
+        const float     v0     = (sprite != nullptr ? float(sprite->cell.y) * scale : 0.0f);
+        const float     u1     = (u0 + (float((2 * radius) + 2) * scale));
+        const float     v1     = (v0 + (float((2 * radius) + 2) * scale));
+        const int       base   = int(vertices.size());
+        vertices.push_back(VertexType{SDL_FPoint{(xc - extent), (yc - extent)}, white, SDL_FPoint{u0, v0}});
+        vertices.push_back(VertexType{SDL_FPoint{(xc + extent), (yc - extent)}, white, SDL_FPoint{u1, v0}});
+        vertices.push_back(VertexType{SDL_FPoint{(xc + extent), (yc + extent)}, white, SDL_FPoint{u1, v1}});
+        vertices.push_back(VertexType{SDL_FPoint{(xc - extent), (yc + extent)}, white, SDL_FPoint{u0, v1}});
+        for(int corner : { 0, 1, 2, 0, 2, 3 }) {
+            indices.push_back(base + corner);
+        }
+    };
+
+    auto add_balls = [&]() -> void
+    {
+        for(auto color : colors) {
+            const int first = int(indices.size());
+            for(int index = 0; index < balls; ++index) {
+                if(colors[index % 4] == color) {
+                    add_ball(index, color);
+                }
+            }
+            add_command(DrawType::SPRITES, color, first, (int(indices.size()) - first));
+        }
+    };
+
+    auto add_particles = [&]() -> void
+    {
+        for(int index = 0; index < particles; ++index) {
+            rects.push_back(RectType{((index * 7919) % width), ((index * 104729) % height), 3, 3});
+        }
+        add_command(DrawType::RECTS, 0xffc04080, 0, particles);
+    };
+
+    const RasterScene scene = [&]() -> RasterScene
+    {
+        add_polygon();
+        add_balls();
+        add_particles();
+        return RasterScene{commands.data(), int(commands.size()), shapes.data(), vertices.data(), indices.data(), rects.data(), 0x000000ff, false, false, 1.0f};
+    }();
+
+    auto run_raster = [&](int count) -> double
+    {
+        Raster rasterizer(count);
+        rasterizer.reserve(int(shapes.size() + (vertices.size() / 4) + rects.size()));
+        const double elapsed = measure(frames, [&]()
+        {
+            rasterizer.render(scene, pixels.data(), (width * int(sizeof(uint32_t))), width, height);
+            sink = sink + pixels[(height / 2) * width + (width / 2)];
+        });
+        stream << "raster/tiles x" << rasterizer.threads() << " ... " << (elapsed / 1e6) << " ms/frame" << std::endl;
+        return elapsed;
+    };
+
+    auto run_sdl = [&]() -> double
+    {
+        if(bool(renderer) == false) {
+            stream << "raster/sdl software ... unavailable" << std::endl;
+            return 0.0;
+        }
+        const double elapsed = measure(frames, [&]()
+        {
+            ::SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 255);
+            ::SDL_RenderClear(renderer.get());
+            for(auto& command : commands) {
+                const SDL_Color rgba = { uint8_t(command.color >> 24), uint8_t(command.color >> 16), uint8_t(command.color >> 8), uint8_t(command.color) };
+                ::SDL_SetRenderDrawColor(renderer.get(), rgba.r, rgba.g, rgba.b, rgba.a);
+                if(command.type == DrawType::LINES) {
+                    for(int index = command.first; index < (command.first + command.count); ++index) {
+                        ::SDL_RenderDrawLine(renderer.get(), int(shapes[index].x1), int(shapes[index].y1), int(shapes[index].x2), int(shapes[index].y2));
+                    }
+                }
+                else if(command.type == DrawType::SPRITES) {
+                    ::SDL_RenderGeometry(renderer.get(), sprites.texture(), vertices.data(), int(vertices.size()), &indices[command.first], command.count);
+                }
+                else if(command.type == DrawType::RECTS) {
+                    ::SDL_RenderFillRects(renderer.get(), &rects[command.first], command.count);
+                }
+            }
+            ::SDL_RenderFlush(renderer.get());
+        });
+        stream << "raster/sdl software ... " << (elapsed / 1e6) << " ms/frame" << std::endl;
+        return elapsed;
+    };
+
+    /*
+     * cost per pixel of the anti-aliased discs against solid squares of the
+     * same area, the cost of the background alone being subtracted
+     */
+    auto run_coverage = [&]() -> void
+    {
+        std::vector<Shape>    discs;
+        std::vector<RectType> squares;
+        double                area = 0.0;
+        for(int index = 0; index < balls; ++index) {
+            const float radius = float(8 + ((index % 4) * 4));
+            const float xc     = (20.25f + float((index * 397) % (width  - 40)));
+            const float yc     = (20.75f + float((index * 631) % (height - 40)));
+            const int   side   = int((radius * ::sqrtf(float(M_PI))) + 0.5f);
+            discs.push_back(Shape{xc, yc, xc, yc, radius});
+            squares.push_back(RectType{(int(xc) - (side / 2)), (int(yc) - (side / 2)), side, side});
+            area += double(side * side);
+        }
+        const DrawCommand disc_command = { DrawType::DISCS, 0x40c0ffff, 0, balls, 0 };
+        const DrawCommand rect_command = { DrawType::RECTS, 0x40c0ffff, 0, balls, 0 };
+        const RasterScene empty_scene  = { nullptr, 0, nullptr, nullptr, nullptr, nullptr, 0x000000ff, false, false, 1.0f };
+        const RasterScene disc_scene   = { &disc_command, 1, discs.data(), nullptr, nullptr, nullptr, 0x000000ff, false, false, 1.0f };
+        const RasterScene rect_scene   = { &rect_command, 1, nullptr, nullptr, nullptr, squares.data(), 0x000000ff, false, false, 1.0f };
+        Raster rasterizer(1);
+        rasterizer.reserve(balls);
+        auto run_scene = [&](const RasterScene& frame) -> double
+        {
+            return measure(frames, [&]()
+            {
+                rasterizer.render(frame, pixels.data(), (width * int(sizeof(uint32_t))), width, height);
+                sink = sink + pixels[(height / 2) * width + (width / 2)];
+            });
+        };
+        const double empty = run_scene(empty_scene);
+        const double sdf   = ((run_scene(disc_scene) - empty) / area);
+        const double solid = ((run_scene(rect_scene) - empty) / area);
+        stream << "raster/sdf discs ... " << sdf << " ns/pixel" << std::endl;
+        stream << "raster/solid rects ... " << solid << " ns/pixel" << std::endl;
+        stream << "raster/sdf vs solid ... " << (sdf / solid) << "x" << std::endl;
+    };
+
+    const double single   = run_raster(1);
+    const double parallel = run_raster(threads);
+    const double software = run_sdl();
+    stream << "raster/parallel speedup ... " << (single / parallel) << "x" << std::endl;
+    if(software > 0.0) {
+        stream << "raster/tiles vs sdl ... " << (software / parallel) << "x" << std::endl;
+    }
+    run_coverage();
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
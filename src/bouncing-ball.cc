@@ -24,8 +24,10 @@
 #include <cstdint>
 #include <cstdarg>
 #include <cmath>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -35,8 +37,58 @@
 #include <emscripten.h>
 #endif
 #include "globals.h"
+#include "realtime.h"
+#include "fixed.h"
 #include "bouncing-ball.h"
 
+// ---------------------------------------------------------------------------
+// <anonymous>::constants
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int   particle_capacity = 16384;
+constexpr int   contact_capacity  = 4096;
+constexpr float substep_dtime     = (1.0f / 240.0f);
+constexpr double substep_ticks    = (1000.0 / 240.0);
+constexpr double max_lag_ticks    = 100.0;
+constexpr uint32_t drag_window    = 8;
+constexpr size_t thread_arena     = (1024 * 1024);
+constexpr float zoom_step         = 1.25f;
+
+auto checksum(const Object& object, uint64_t hash) -> uint64_t
+{
+    const float values[4] = {
+        object.position().x,
+        object.position().y,
+        object.velocity().x,
+        object.velocity().y,
+    };
+    for(auto& value : values) {
+        uint32_t bits;
+        ::memcpy(&bits, &value, sizeof(bits));
+        hash = ((hash ^ bits) * UINT64_C(1099511628211));
+    }
+    return hash;
+}
+
+auto present_name(int present_mode) -> const char*
+{
+    switch(present_mode) {
+        case PresentType::IMMEDIATE:
+            return "immediate";
+        case PresentType::CAPPED:
+            return "capped";
+        case PresentType::LATEST:
+            return "latest";
+        default:
+            break;
+    }
+    return "vsync";
+}
+
+}
+
 // ---------------------------------------------------------------------------
 // BouncingBall
 // ---------------------------------------------------------------------------
@@ -44,21 +96,76 @@
 BouncingBall::BouncingBall(const int width, const int height)
     : Application("Bouncing Ball")
     , _canvas(nullptr)
-    , _poly(nullptr)
-    , _ball(nullptr)
+    , _world()
+    , _particles(particle_capacity)
+    , _trails(Globals::trail_length, Globals::ball_count)
+    , _heatmap(width, height)
+    , _show_heatmap(false)
+    , _occupancy()
+    , _record_heatmap(false)
     , _size()
     , _center()
     , _color(0.12f, 0.12f, 0.12f)
+    , _contacts(0)
+    , _commands()
+    , _snapshots()
+    , _thread()
+    , _thread_quit(false)
+    , _thread_arena(thread_arena)
+    , _rendered()
+    , _pending()
+    , _has_pending(false)
+    , _ticks(0.0)
+    , _simulated(false)
+    , _latency()
+    , _applied_input(-1)
+    , _input_time(-1)
+    , _sim_scale(Globals::time_scale)
+    , _sim_budget(0.0f)
+    , _sim_steps(0)
+    , _caption_steps(0)
+    , _caption_time(0)
+    , _sim_rate(0.0)
+    , _drag{CommandType::RELEASE, Pos2f(), Vec2f(), 0.0f, 0}
+    , _drag_anchor()
+    , _drag_time(0)
+    , _latch_poly()
+    , _latch_ball()
+    , _quality(Globals::target_frame)
+    , _frame_start(0)
+    , _substep_dtime(substep_dtime)
+    , _substep_ticks(substep_ticks)
+    , _iterations(1)
+    , _jitter_sum(0)
+    , _jitter_max(0)
+    , _jitter_count(0)
 {
     create_canvas(width, height);
     create_poly();
     create_ball();
+    if(Globals::prefault != false) {
+        _arena.prefault();
+        _thread_arena.prefault();
+    }
+    start_thread();
+    if(_thread.joinable() == false) {
+        Realtime::setup_thread("the main loop");
+    }
+    Realtime::lock_memory();
+}
+
+BouncingBall::~BouncingBall()
+{
+    stop_thread();
 }
 
 auto BouncingBall::create_canvas(int width, int height) -> void
 {
     if(bool(_canvas) == false) {
-        _canvas = std::make_unique<Canvas>(_title, width, height);
+        if(Globals::headless == false) {
+            _canvas = std::make_unique<Canvas>(_title, width, height);
+            _canvas->reserve(GlobalsMax::poly_vertices, Globals::ball_count, particle_capacity, (Globals::ball_count * Globals::trail_length));
+        }
         _size   = Vec2f(width, height);
         _center = Pos2f(Pos2f() + (_size / 2.0f));
     }
@@ -72,10 +179,22 @@ auto BouncingBall::create_poly() -> void
     const float poly_friction = Globals::poly_friction;
     const float poly_gravity  = Globals::poly_gravity;
 
-    _poly = std::make_unique<Poly>(_center, poly_vertices, poly_radius);
-    _poly->set_omega(poly_omega);
-    _poly->set_friction(Vec2f(poly_friction, 0.0f));
-    _poly->set_gravity(Vec2f(0.0f, poly_gravity));
+    auto& polys(_world.polys());
+
+    if(polys.empty() != false) {
+        polys.emplace_back(_center, poly_vertices, poly_radius);
+    }
+    for(auto& poly : polys) {
+        poly.set_position(_center);
+        poly.set_velocity(Vec2f(0.0f, 0.0f));
+        poly.set_vertices(poly_vertices);
+        poly.set_radius(poly_radius);
+        poly.set_angle(0.0f);
+        poly.set_frozen(false);
+        poly.set_omega(poly_omega);
+        poly.set_friction(Vec2f(poly_friction, 0.0f));
+        poly.set_gravity(Vec2f(0.0f, poly_gravity));
+    }
 }
 
 auto BouncingBall::create_ball() -> void
@@ -83,10 +202,47 @@ auto BouncingBall::create_ball() -> void
     const float ball_radius   = Globals::ball_radius;
     const float ball_friction = Globals::ball_friction;
     const float ball_gravity  = Globals::ball_gravity;
+    const int   ball_count    = Globals::ball_count;
+    const float ball_spread   = (0.5f * std::max(0.0f, Globals::poly_radius - ball_radius));
+
+    /*
+     * the first ball starts at the center, the other ones are laid out on a
+     * golden-angle spiral so that a given count always yields the same scene,
+     * using the fixed-point trigonometry in deterministic mode since the libm
+     * sinf/cosf may differ between builds and platforms
+     */
+    auto position = [&](int index) -> Pos2f
+    {
+        constexpr float golden_angle = 2.39996323f;
 
-    _ball = std::make_unique<Ball>(_center, ball_radius);
-    _ball->set_friction(Vec2f(ball_friction, ball_friction));
-    _ball->set_gravity(Vec2f(0.0f, ball_gravity));
+        if(Globals::fixed_point != false) {
+            const Fixed radius(Fixed(ball_spread) * sqrt(Fixed(index) / Fixed(ball_count)));
+            const Fixed angle(Fixed(golden_angle) * index);
+            return _center + Vec2f((radius * cos(angle)).to_float(), (radius * sin(angle)).to_float());
+        }
+        const float radius = ball_spread * ::sqrtf(float(index) / float(ball_count));
+        const float angle  = golden_angle * float(index);
+        return _center + Vec2f((radius * ::cosf(angle)), (radius * ::sinf(angle)));
+    };
+
+    auto& balls(_world.balls());
+
+    while(int(balls.size()) < ball_count) {
+        balls.emplace_back(_center, ball_radius);
+    }
+    if(int(balls.size()) > ball_count) {
+        balls.erase((balls.begin() + ball_count), balls.end());
+    }
+
+    int index = 0;
+    for(auto& ball : balls) {
+        ball.set_position(position(index++));
+        ball.set_velocity(Vec2f(0.0f, 0.0f));
+        ball.set_radius(ball_radius);
+        ball.set_frozen(false);
+        ball.set_friction(Vec2f(ball_friction, ball_friction));
+        ball.set_gravity(Vec2f(0.0f, ball_gravity));
+    }
 }
 
 auto BouncingBall::toggle_underlay() -> void
@@ -99,6 +255,30 @@ auto BouncingBall::toggle_overlay() -> void
     _canvas->toggle_overlay();
 }
 
+/*
+ * the heatmap starts afresh whenever it is shown, and the occupancy is not
+ * recorded by the simulation at all while it is hidden
+ */
+auto BouncingBall::toggle_heatmap() -> void
+{
+    _show_heatmap = !_show_heatmap;
+    if(_show_heatmap != false) {
+        _heatmap.clear();
+    }
+    else {
+        _canvas->remove_heatmap();
+    }
+    dispatch(Command{CommandType::SET_HEATMAP, Pos2f(), Vec2f(), (_show_heatmap ? 1.0f : 0.0f), ::SDL_GetTicks()});
+}
+
+auto BouncingBall::cycle_present_mode() -> void
+{
+    Globals::set_present_mode((Globals::present_mode + 1) % PresentType::COUNT);
+
+    _canvas->set_present_mode(Globals::present_mode);
+    std::cout << "present: " << present_name(Globals::present_mode) << std::endl;
+}
+
 auto BouncingBall::set_poly_vertices(int poly_vertices) -> void
 {
     Globals::set_poly_vertices(poly_vertices);
@@ -110,21 +290,34 @@ auto BouncingBall::set_poly_radius(float poly_radius) -> void
 {
     Globals::set_poly_radius(poly_radius);
 
-    _poly->set_radius(Globals::poly_radius);
+    for(auto& poly : _world.polys()) {
+        poly.set_radius(Globals::poly_radius);
+    }
 }
 
 auto BouncingBall::set_poly_omega(float poly_omega) -> void
 {
     Globals::set_poly_omega(poly_omega);
 
-    _poly->set_omega(Globals::poly_omega);
+    for(auto& poly : _world.polys()) {
+        poly.set_omega(Globals::poly_omega);
+    }
 }
 
 auto BouncingBall::set_ball_radius(float ball_radius) -> void
 {
     Globals::set_ball_radius(ball_radius);
 
-    _ball->set_radius(Globals::ball_radius);
+    for(auto& ball : _world.balls()) {
+        ball.set_radius(Globals::ball_radius);
+    }
+}
+
+auto BouncingBall::set_time_scale(float time_scale, uint32_t timestamp) -> void
+{
+    Globals::set_time_scale(time_scale);
+
+    dispatch(Command{CommandType::SET_TIME_SCALE, Pos2f(), Vec2f(), Globals::time_scale, timestamp});
 }
 
 auto BouncingBall::resized(int width, int height) -> void
@@ -135,35 +328,582 @@ auto BouncingBall::resized(int width, int height) -> void
 
     _size   = size;
     _center = center;
-    _poly->set_position(_poly->position() + delta);
-    _ball->set_position(_ball->position() + delta);
+    for(auto& poly : _world.polys()) {
+        poly.set_position(poly.position() + delta);
+    }
+    for(auto& ball : _world.balls()) {
+        ball.set_position(ball.position() + delta);
+    }
+}
+
+auto BouncingBall::checksum() const -> uint64_t
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+
+    for(auto& poly : _world.polys()) {
+        hash = ::checksum(poly, hash);
+    }
+    for(auto& ball : _world.balls()) {
+        hash = ::checksum(ball, hash);
+    }
+    return hash;
+}
+
+auto BouncingBall::headless(std::ostream& stream) -> void
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int   steps = Globals::headless_steps;
+    const float dtime = Globals::headless_dtime;
+    const int   balls = int(_world.balls().size());
+
+    const Clock::time_point start(Clock::now());
+    for(int index = 0; index < steps; ++index) {
+        _arena.reset();
+        step(_arena, _occupancy, dtime, 1);
+    }
+    const Clock::time_point stop(Clock::now());
+
+    const double elapsed = std::chrono::duration<double>(stop - start).count();
+    stream << "headless steps ...... " << steps                                               << std::endl;
+    stream << "headless balls ...... " << balls                                               << std::endl;
+    stream << "headless dt ......... " << dtime                                               << std::endl;
+    stream << "headless steps/s .... " << (double(steps) / elapsed)                           << std::endl;
+    stream << "headless ns/ball .... " << (1e9 * elapsed / (double(steps) * double(balls)))  << std::endl;
+    stream << "headless contacts ... " << _contacts                                           << std::endl;
+    stream << "headless checksum ... " << std::hex << checksum() << std::dec                  << std::endl;
+}
+
+/*
+ * advances the simulation by count steps in a single call, each step being
+ * an update pass followed by a collide pass over the batches of the world.
+ * The contacts are recorded up to the capacity of a single step, the extra
+ * ones are only counted by their absence.
+ */
+auto BouncingBall::step(Arena& arena, Occupancy& occupancy, const float dt, const int count) -> Contacts
+{
+    auto contacts(arena.allocate_array<Contact>(_world.contact_capacity()));
+
+    for(int index = 0; index < count; ++index) {
+        _world.update(dt);
+        _world.collide(&contacts, _iterations);
+        if(_record_heatmap != false) {
+            occupancy.record(_world);
+        }
+    }
+    _contacts.fetch_add(contacts.size(), std::memory_order_relaxed);
+    _sim_steps.fetch_add(count, std::memory_order_relaxed);
+
+    return contacts;
+}
+
+/*
+ * number of steps to simulate during one substep of wall-clock time, with
+ * the fractional part carried over so that slow motion stays smooth
+ */
+auto BouncingBall::scaled_steps() -> int
+{
+    _sim_budget += _sim_scale;
+
+    const int count = int(_sim_budget);
+
+    _sim_budget -= float(count);
+
+    return count;
+}
+
+auto BouncingBall::dispatch(const Command& command) -> void
+{
+    while(_commands.push(command) == false) {
+        if(_thread.joinable() == false) {
+            return apply(command);
+        }
+        std::this_thread::yield();
+    }
+}
+
+/*
+ * applies the queued commands whose event happened before the given time,
+ * a command from the future is kept aside until its substep is reached
+ */
+auto BouncingBall::apply_commands(double ticks) -> bool
+{
+    bool applied = false;
+
+    auto is_due = [&](const Command& command) -> bool
+    {
+        return double(command.timestamp) <= ticks;
+    };
+
+    auto do_apply = [&](const Command& command) -> void
+    {
+        if(_applied_input < 0) {
+            _applied_input = command.timestamp;
+        }
+        apply(command);
+        applied = true;
+    };
+
+    if(_has_pending != false) {
+        if(is_due(_pending) == false) {
+            return applied;
+        }
+        do_apply(_pending);
+        _has_pending = false;
+    }
+    while(_commands.pop(_pending) != false) {
+        if(is_due(_pending) == false) {
+            _has_pending = true;
+            return applied;
+        }
+        do_apply(_pending);
+    }
+    return applied;
+}
+
+auto BouncingBall::apply(const Command& command) -> void
+{
+    auto& poly(_world.polys().front());
+    auto& ball(_world.balls().front());
+
+    switch(command.type) {
+        case CommandType::RESET:
+            create_poly();
+            create_ball();
+            break;
+        case CommandType::RESIZE:
+            resized(int(command.vector.x), int(command.vector.y));
+            break;
+        case CommandType::ADD_POLY_VERTICES:
+            set_poly_vertices(Globals::poly_vertices + int(command.value));
+            break;
+        case CommandType::ADD_POLY_RADIUS:
+            set_poly_radius(poly.radius() + command.value);
+            break;
+        case CommandType::ADD_POLY_OMEGA:
+            set_poly_omega(poly.omega() + command.value);
+            break;
+        case CommandType::ADD_BALL_RADIUS:
+            set_ball_radius(ball.radius() + command.value);
+            break;
+        case CommandType::MOVE_POLY:
+            poly.set_position(command.position);
+            poly.set_velocity(command.vector);
+            poly.set_frozen(false);
+            ball.set_frozen(false);
+            break;
+        case CommandType::MOVE_BALL:
+            ball.set_position(command.position);
+            ball.set_velocity(command.vector);
+            ball.set_frozen(true);
+            poly.set_frozen(false);
+            break;
+        case CommandType::RELEASE:
+            poly.set_frozen(false);
+            ball.set_frozen(false);
+            break;
+        case CommandType::SET_TIME_SCALE:
+            _sim_scale = command.value;
+            break;
+        case CommandType::SET_QUALITY:
+            _substep_dtime = (1.0f / command.vector.x);
+            _substep_ticks = (1000.0 / double(command.vector.x));
+            _iterations    = int(command.vector.y);
+            break;
+        case CommandType::SET_HEATMAP:
+            _record_heatmap = (command.value != 0.0f);
+            break;
+        default:
+            break;
+    }
+}
+
+auto BouncingBall::drag(const Command& command) -> void
+{
+    _drag = command;
+
+    dispatch(command);
+}
+
+/*
+ * offsets the dragged object, for this frame only, from where the simulation
+ * has it to the latest mouse position, so that it does not lag behind the
+ * pointer by the events not yet simulated. The simulated scene is left alone,
+ * the queued move commands being the only ones to move the object.
+ */
+auto BouncingBall::latch() -> void
+{
+    int x = 0;
+    int y = 0;
+
+    _latch_poly = Vec2f();
+    _latch_ball = Vec2f();
+    if((_drag.type == CommandType::RELEASE) || ((::SDL_GetMouseState(&x, &y) & SDL_BUTTON_LMASK) == 0)) {
+        return;
+    }
+    const Camera& camera(_canvas->camera());
+    const Pos2f   position(camera.to_world_x(float(x)), camera.to_world_y(float(y)));
+    if(_drag.type == CommandType::MOVE_BALL) {
+        _latch_ball = (position - scene().balls().front().position());
+    }
+    else {
+        _latch_poly = (position - scene().polys().front().position());
+    }
+}
+
+auto BouncingBall::start_thread() -> void
+{
+    auto init_snapshot = [&](Snapshot& snapshot) -> void
+    {
+        snapshot.world.assign(_world);
+        snapshot.contacts.clear();
+        snapshot.contacts.reserve(contact_capacity);
+        snapshot.occupancy.clear();
+        snapshot.steps = 0;
+        snapshot.input = -1;
+    };
+
+    if((Globals::threaded != false) && (bool(_canvas) != false) && (_thread.joinable() == false)) {
+        _snapshots.for_each(init_snapshot);
+        _thread_quit.store(false, std::memory_order_relaxed);
+        _thread = std::thread(&BouncingBall::run_thread, this);
+    }
+}
+
+auto BouncingBall::stop_thread() -> void
+{
+    if(_thread.joinable() != false) {
+        _thread_quit.store(true, std::memory_order_release);
+        _thread.join();
+    }
+}
+
+auto BouncingBall::run_thread() -> void
+{
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point deadline(Clock::now());
+    uint64_t          steps = 0;
+
+    /*
+     * the lateness of every wake-up is accumulated for the statistics as
+     * the scheduling jitter of the thread
+     */
+    auto jitter = [&]() -> void
+    {
+        const Clock::duration late(Clock::now() - deadline);
+        const uint64_t        nsec = (late > Clock::duration::zero() ? uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(late).count()) : 0);
+        uint64_t              highest = _jitter_max.load(std::memory_order_relaxed);
+        while((nsec > highest) && (_jitter_max.compare_exchange_weak(highest, nsec, std::memory_order_relaxed) == false)) {
+            continue;
+        }
+        _jitter_sum.fetch_add(nsec, std::memory_order_relaxed);
+        _jitter_count.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    auto publish = [&](const Contacts& contacts) -> void
+    {
+        Snapshot& snapshot(_snapshots.back());
+        snapshot.world.assign(_world);
+        for(auto& contact : contacts) {
+            if(snapshot.contacts.size() < snapshot.contacts.capacity()) {
+                snapshot.contacts.push_back(contact);
+            }
+        }
+        snapshot.steps = ++steps;
+        if(snapshot.input < 0) {
+            snapshot.input = _applied_input;
+        }
+        _applied_input = -1;
+        if(_snapshots.publish() != false) {
+            _snapshots.back().contacts.clear();
+            _snapshots.back().input = -1;
+        }
+    };
+
+    Realtime::setup_thread("the simulation thread");
+    while(_thread_quit.load(std::memory_order_acquire) == false) {
+        const bool applied = apply_commands(double(::SDL_GetTicks()));
+        const int  count   = scaled_steps();
+        _thread_arena.reset();
+        if((applied != false) || (count != 0)) {
+            publish(step(_thread_arena, _snapshots.back().occupancy, _substep_dtime, count));
+        }
+        deadline += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(_substep_dtime));
+        const Clock::time_point now(Clock::now());
+        if((now - deadline) > std::chrono::milliseconds(100)) {
+            deadline = now;
+        }
+        std::this_thread::sleep_until(deadline);
+        jitter();
+    }
 }
 
 auto BouncingBall::update() -> void
 {
-    auto& poly(*_poly);
-    auto& ball(*_ball);
+    const bool  visible = (bool(_canvas) != false);
+    const Vec2f gravity(0.0f, Globals::ball_gravity);
+
+    auto emit = [&](const Contact* first, const Contact* last) -> void
+    {
+        if(visible != false) {
+            for(auto contact = first; contact != last; ++contact) {
+                _particles.emit(*contact);
+            }
+        }
+    };
+
+    /*
+     * the particles follow the simulated time rather than the wall-clock
+     * time, through the time scale of the main thread since the one of the
+     * simulation is owned by the simulation thread
+     */
+    if(visible != false) {
+        _particles.update((_dtime * Globals::time_scale), gravity);
+    }
+    auto substeps = [&]() -> void
+    {
+        const double ticks = double(::SDL_GetTicks());
+        if((ticks - _ticks) > max_lag_ticks) {
+            _ticks = (ticks - _substep_ticks);
+        }
+        while((_ticks + _substep_ticks) <= ticks) {
+            _ticks += _substep_ticks;
+            const bool applied = apply_commands(_ticks);
+            const int  count   = scaled_steps();
+            if((applied != false) || (count != 0)) {
+                const Contacts contacts(step(_arena, _occupancy, _substep_dtime, count));
+                emit(contacts.begin(), contacts.end());
+                _simulated = true;
+            }
+        }
+    };
+
+    auto input = [&](int64_t timestamp) -> void
+    {
+        if((timestamp >= 0) && (_input_time < 0)) {
+            _input_time = timestamp;
+        }
+    };
 
-    poly.update(_dtime);
-    ball.update(_dtime);
-    ball.collide(poly);
+    _frame_start = ::SDL_GetPerformanceCounter();
+    _simulated   = false;
+    if(_thread.joinable() == false) {
+        substeps();
+        input(_applied_input);
+        _applied_input = -1;
+    }
+    else if(_snapshots.acquire() != false) {
+        _simulated = true;
+        const Snapshot& snapshot(_snapshots.front());
+        emit(snapshot.contacts.data(), (snapshot.contacts.data() + snapshot.contacts.size()));
+        input(snapshot.input);
+    }
+}
+
+auto BouncingBall::scene() -> World&
+{
+    if(_thread.joinable() != false) {
+        return _snapshots.front().world;
+    }
+    return _world;
+}
+
+auto BouncingBall::occupancy() -> Occupancy&
+{
+    if(_thread.joinable() != false) {
+        return _snapshots.front().occupancy;
+    }
+    return _occupancy;
 }
 
 auto BouncingBall::render() -> void
 {
+    latch();
+
     auto& canvas(*_canvas);
-    auto& poly(*_poly);
-    auto& ball(*_ball);
+    auto& world(scene());
+
+    auto remember = [&]() -> void
+    {
+        _rendered.clear();
+        for(auto& poly : world.polys()) {
+            _rendered.push_back(poly.position());
+            _rendered.push_back(Pos2f(poly.angle(), poly.radius()));
+            _rendered.push_back(Pos2f(float(poly.size()), 0.0f));
+        }
+        for(auto& ball : world.balls()) {
+            _rendered.push_back(ball.position());
+            _rendered.push_back(Pos2f(ball.radius(), 0.0f));
+        }
+    };
+
+    /*
+     * the occupancy recorded by the steps simulated since the last frame is
+     * merged into the heatmap before the frame is cleared, so that an upload
+     * is shown right away, then cleared to be recorded afresh
+     */
+    auto accumulate = [&]() -> void
+    {
+        auto& recorded(occupancy());
+        if(_show_heatmap != false) {
+            _heatmap.resize(int(canvas.camera().width()), int(canvas.camera().height()));
+            _heatmap.update(recorded);
+            _heatmap.render(canvas);
+        }
+        recorded.clear();
+    };
 
+    accumulate();
     canvas.color(_color);
     canvas.clear();
-    poly.render(canvas);
-    ball.render(canvas);
-    canvas.present();
+    _trails.render(canvas, world);
+    world.render(canvas, _latch_poly, _latch_ball);
+    _particles.render(canvas, _arena);
+    canvas.flush();
+    update_quality();
+    const bool presented = canvas.present();
+    remember();
+    if((presented != false) && (_input_time >= 0)) {
+        _latency.add(::SDL_GetTicks() - uint32_t(_input_time));
+        _input_time = -1;
+    }
+    update_caption();
+}
+
+/*
+ * shows the time scale and the measured simulated seconds per second in
+ * the window caption, refreshed once per second
+ */
+auto BouncingBall::update_caption() -> void
+{
+    const uint32_t ticks   = ::SDL_GetTicks();
+    const uint32_t elapsed = (ticks - _caption_time);
+
+    if(elapsed >= 1000) {
+        const uint64_t steps = _sim_steps.load(std::memory_order_relaxed);
+        char           caption[256];
+        _sim_rate      = (double(steps - _caption_steps) * 1000.0 / (double(_quality.level().substep_rate) * double(elapsed)));
+        _caption_steps = steps;
+        _caption_time  = ticks;
+        ::snprintf(caption, sizeof(caption), "%s - %gx - %.2f sim s/s", _title.c_str(), double(Globals::time_scale), _sim_rate);
+        _canvas->set_caption(caption);
+    }
+}
+
+/*
+ * feeds the time spent on the frame so far to the quality controller and
+ * applies its new level, the rendering settings in place and the simulation
+ * settings through a command
+ */
+auto BouncingBall::update_quality() -> void
+{
+    const double frame_time = (double(::SDL_GetPerformanceCounter() - _frame_start) * 1000.0 / double(::SDL_GetPerformanceFrequency()));
+
+    if(_quality.sample(float(frame_time)) != false) {
+        const QualityLevel& level(_quality.level());
+        _canvas->set_circle_lod(level.circle_lod);
+        _canvas->set_resolution(level.render_scale);
+        _particles.set_density(level.particle_density);
+        dispatch(Command{CommandType::SET_QUALITY, Pos2f(), Vec2f(float(level.substep_rate), float(level.iterations)), 0.0f, ::SDL_GetTicks()});
+    }
 }
 
 auto BouncingBall::shutdown() -> void
 {
+    stop_thread();
+    if(_latency.count() != 0) {
+        _latency.print(std::cout);
+    }
+}
+
+auto BouncingBall::stats(std::ostream& stream) -> void
+{
+    stream << ", sim " << _sim_rate << " s/s at " << Globals::time_scale << "x";
+    stream << ", contacts " << _contacts.exchange(0, std::memory_order_relaxed);
+    if(bool(_canvas) != false) {
+        const SpriteCache& sprites(_canvas->sprites());
+        stream << ", draw calls " << _canvas->draw_calls();
+        stream << ", " << present_name(Globals::present_mode) << " presented " << _canvas->presented() << " (dropped " << _canvas->dropped() << ')';
+        _canvas->reset_presents();
+        if((Globals::dirty_rects != false) && (Globals::software == false)) {
+            stream << ", dirty " << int(100.0f * _canvas->dirty().area()) << '%';
+        }
+        stream << ", sprites " << sprites.size() << " (misses " << sprites.misses() << ", evictions " << sprites.evictions() << ')';
+    }
+    if(_thread.joinable() != false) {
+        const uint64_t count = std::max(uint64_t(1), _jitter_count.exchange(0, std::memory_order_relaxed));
+        stream << ", jitter " << (1e-3 * double(_jitter_sum.exchange(0, std::memory_order_relaxed)) / double(count)) << "us"
+               << " (max "    << (1e-3 * double(_jitter_max.exchange(0, std::memory_order_relaxed))) << "us)";
+    }
+    if(_quality.enabled() != false) {
+        stream << ", quality " << _quality.index() << " (" << _quality.average() << " ms)";
+    }
+    stream << ", particles " << _particles.size() << '/' << _particles.capacity();
+    stream << " (high-water " << _particles.high_water() << ", dropped " << _particles.dropped() << ')';
+    if(_trails.length() != 0) {
+        const uint32_t frames = std::max(uint32_t(1), _trails.frames());
+        stream << ", trails " << _trails.length() << 'x' << _trails.balls() << " (" << (_trails.bytes() / 1024) << " KiB"
+               << ", " << (1e6 * double(_trails.time()) / (double(frames) * double(::SDL_GetPerformanceFrequency()))) << "us)";
+        _trails.reset_time();
+    }
+    if(_show_heatmap != false) {
+        const uint32_t frames = std::max(uint32_t(1), _heatmap.frames());
+        stream << ", heatmap " << _heatmap.cols() << 'x' << _heatmap.rows()
+               << " (" << (1e6 * double(_heatmap.time()) / (double(frames) * double(::SDL_GetPerformanceFrequency()))) << "us)";
+        _heatmap.reset_time();
+    }
+}
+
+/*
+ * the scene is idle when the latest simulation step left it at rest: no
+ * poly moves or rotates, no ball moves, and what would be rendered is
+ * unchanged since the last rendered frame. The angles have their own
+ * tolerance, in radians, so that a slowly rotating poly is not frozen,
+ * and the velocities are checked along with the positions so that a ball
+ * is not frozen at the apex of a bounce. No particle may be alive and the
+ * trails must have settled.
+ */
+auto BouncingBall::idle() -> bool
+{
+    constexpr float pixel_epsilon = 0.01f;
+    constexpr float angle_epsilon = 1e-5f;
+    auto&           world(scene());
+    auto            rendered(_rendered.begin());
+
+    auto unchanged = [&](const Pos2f& current, const float epsilon_x, const float epsilon_y) -> bool
+    {
+        const Pos2f& previous(*rendered++);
+        return (::fabsf(current.x - previous.x) < epsilon_x)
+            && (::fabsf(current.y - previous.y) < epsilon_y);
+    };
+
+    auto still = [&](const Vec2f& velocity) -> bool
+    {
+        return (::fabsf(velocity.x) < pixel_epsilon)
+            && (::fabsf(velocity.y) < pixel_epsilon);
+    };
+
+    if((_simulated == false) || (_input_time >= 0) || (_particles.size() != 0) || (_trails.settled() == false) || (_rendered.size() != ((3 * world.polys().size()) + (2 * world.balls().size())))) {
+        return false;
+    }
+    for(auto& poly : world.polys()) {
+        if((still(poly.velocity()) == false)
+        || (::fabsf(poly.omega()) >= angle_epsilon)
+        || (unchanged(poly.position(), pixel_epsilon, pixel_epsilon) == false)
+        || (unchanged(Pos2f(poly.angle(), poly.radius()), angle_epsilon, pixel_epsilon) == false)
+        || (unchanged(Pos2f(float(poly.size()), 0.0f), pixel_epsilon, pixel_epsilon) == false)) {
+            return false;
+        }
+    }
+    for(auto& ball : world.balls()) {
+        if((still(ball.velocity()) == false)
+        || (unchanged(ball.position(), pixel_epsilon, pixel_epsilon) == false)
+        || (unchanged(Pos2f(ball.radius(), 0.0f), pixel_epsilon, pixel_epsilon) == false)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 auto BouncingBall::on_quit(const QuitEventType& event) -> void
@@ -175,7 +915,8 @@ auto BouncingBall::on_window(const WindowEventType& event) -> void
 {
     switch(event.event) {
         case SDL_WINDOWEVENT_RESIZED:
-            resized(event.data1, event.data2);
+            _canvas->invalidate();
+            dispatch(Command{CommandType::RESIZE, Pos2f(), Vec2f(event.data1, event.data2), 0.0f, event.timestamp});
             break;
         case SDL_WINDOWEVENT_CLOSE:
             quit();
@@ -198,27 +939,53 @@ auto BouncingBall::on_key_press(const KeyboardEventType& event) -> void
             case SDLK_u:
                 toggle_underlay();
                 break;
+            case SDLK_m:
+                toggle_heatmap();
+                break;
+            case SDLK_l:
+                _latency.print(std::cout);
+                break;
+            case SDLK_p:
+                cycle_present_mode();
+                break;
+            case SDLK_c:
+                _canvas->camera().reset();
+                break;
+            case SDLK_PLUS:
+            case SDLK_EQUALS:
+            case SDLK_KP_PLUS:
+                set_time_scale((Globals::time_scale * 2.0f), event.timestamp);
+                break;
+            case SDLK_MINUS:
+            case SDLK_KP_MINUS:
+                set_time_scale((Globals::time_scale / 2.0f), event.timestamp);
+                break;
+            case SDLK_0:
+                set_time_scale(1.0f, event.timestamp);
+                break;
             case SDLK_r:
-                create_poly();
-                create_ball();
+                dispatch(Command{CommandType::RESET, Pos2f(), Vec2f(), 0.0f, event.timestamp});
+                _particles.clear();
+                _trails.clear();
+                _heatmap.clear();
                 break;
             case SDLK_q:
                 quit();
                 break;
             case SDLK_UP:
-                set_poly_vertices(Globals::poly_vertices + 1);
+                dispatch(Command{CommandType::ADD_POLY_VERTICES, Pos2f(), Vec2f(), +1.0f, event.timestamp});
                 break;
             case SDLK_DOWN:
-                set_poly_vertices(Globals::poly_vertices - 1);
+                dispatch(Command{CommandType::ADD_POLY_VERTICES, Pos2f(), Vec2f(), -1.0f, event.timestamp});
                 break;
             case SDLK_LEFT:
                 {
                     const float value = (1.5f * _dtime);
                     if(mods & (KMOD_LSHIFT | KMOD_RSHIFT)) {
-                        set_poly_omega(_poly->omega() - (2.0f * value));
+                        dispatch(Command{CommandType::ADD_POLY_OMEGA, Pos2f(), Vec2f(), -(2.0f * value), event.timestamp});
                     }
                     else {
-                        set_poly_omega(_poly->omega() - (1.0f * value));
+                        dispatch(Command{CommandType::ADD_POLY_OMEGA, Pos2f(), Vec2f(), -(1.0f * value), event.timestamp});
                     }
                 }
                 break;
@@ -226,10 +993,10 @@ auto BouncingBall::on_key_press(const KeyboardEventType& event) -> void
                 {
                     const float value = (1.5f * _dtime);
                     if(mods & (KMOD_LSHIFT | KMOD_RSHIFT)) {
-                        set_poly_omega(_poly->omega() + (2.0f * value));
+                        dispatch(Command{CommandType::ADD_POLY_OMEGA, Pos2f(), Vec2f(), +(2.0f * value), event.timestamp});
                     }
                     else {
-                        set_poly_omega(_poly->omega() + (1.0f * value));
+                        dispatch(Command{CommandType::ADD_POLY_OMEGA, Pos2f(), Vec2f(), +(1.0f * value), event.timestamp});
                     }
                 }
                 break;
@@ -251,59 +1018,52 @@ auto BouncingBall::on_key_release(const KeyboardEventType& event) -> void
 auto BouncingBall::on_mouse_motion(const MouseMotionEventType& event) -> void
 {
     const auto mods = ::SDL_GetModState();
+    Camera&    camera(_canvas->camera());
 
+    if((event.state & SDL_BUTTON_RMASK) != 0) {
+        camera.pan(float(event.xrel), float(event.yrel));
+    }
     if((event.state & SDL_BUTTON_LMASK) != 0) {
-        auto& poly(*_poly);
-        auto& ball(*_ball);
-        if(mods & (KMOD_LSHIFT | KMOD_RSHIFT)) {
-            const float pos_x = float(event.x);
-            const float pos_y = float(event.y);
-            const float vel_x = float(event.xrel * 50);
-            const float vel_y = float(event.yrel * 50);
-            ball.set_position(Pos2f(pos_x, pos_y));
-            ball.set_velocity(Vec2f(vel_x, vel_y));
-            ball.set_frozen(true);
-            poly.set_frozen(false);
+        const Pos2f position(camera.to_world_x(float(event.x)), camera.to_world_y(float(event.y)));
+        if(_drag.type == CommandType::RELEASE) {
+            _drag.type  = ((mods & (KMOD_LSHIFT | KMOD_RSHIFT)) ? CommandType::MOVE_BALL : CommandType::MOVE_POLY);
+            _drag_anchor = position;
+            _drag_time   = event.timestamp;
+        }
+        if(_drag.type == CommandType::MOVE_BALL) {
+            /*
+             * the velocity is measured over a window of event time rather
+             * than per event, so that it does not depend on the event rate
+             */
+            const uint32_t elapsed = (event.timestamp - _drag_time);
+            Vec2f          velocity(_drag.vector);
+            if(elapsed >= drag_window) {
+                velocity     = ((position - _drag_anchor) * (1000.0f / float(elapsed)));
+                _drag_anchor = position;
+                _drag_time   = event.timestamp;
+            }
+            drag(Command{CommandType::MOVE_BALL, position, velocity, 0.0f, event.timestamp});
         }
         else {
-            const float pos_x = float(event.x);
-            const float pos_y = float(event.y);
-            const float vel_x = float(0);
-            const float vel_y = float(0);
-            poly.set_position(Pos2f(pos_x, pos_y));
-            poly.set_velocity(Vec2f(vel_x, vel_y));
-            poly.set_frozen(false);
-            ball.set_frozen(false);
+            drag(Command{CommandType::MOVE_POLY, position, Vec2f(0.0f, 0.0f), 0.0f, event.timestamp});
         }
     }
 }
 
 auto BouncingBall::on_mouse_button_press(const MouseButtonEventType& event) -> void
 {
-    const auto mods = ::SDL_GetModState();
+    const auto    mods = ::SDL_GetModState();
+    const Camera& camera(_canvas->camera());
 
     if(event.button == SDL_BUTTON_LEFT) {
-        auto& poly(*_poly);
-        auto& ball(*_ball);
+        const Pos2f position(camera.to_world_x(float(event.x)), camera.to_world_y(float(event.y)));
+        _drag_anchor = position;
+        _drag_time   = event.timestamp;
         if(mods & (KMOD_LSHIFT | KMOD_RSHIFT)) {
-            const float pos_x = float(event.x);
-            const float pos_y = float(event.y);
-            const float vel_x = float(0);
-            const float vel_y = float(0);
-            ball.set_position(Pos2f(pos_x, pos_y));
-            ball.set_velocity(Vec2f(vel_x, vel_y));
-            ball.set_frozen(true);
-            poly.set_frozen(false);
+            drag(Command{CommandType::MOVE_BALL, position, Vec2f(0.0f, 0.0f), 0.0f, event.timestamp});
         }
         else {
-            const float pos_x = float(event.x);
-            const float pos_y = float(event.y);
-            const float vel_x = float(0);
-            const float vel_y = float(0);
-            poly.set_position(Pos2f(pos_x, pos_y));
-            poly.set_velocity(Vec2f(vel_x, vel_y));
-            poly.set_frozen(false);
-            ball.set_frozen(false);
+            drag(Command{CommandType::MOVE_POLY, position, Vec2f(0.0f, 0.0f), 0.0f, event.timestamp});
         }
     }
 }
@@ -311,10 +1071,7 @@ auto BouncingBall::on_mouse_button_press(const MouseButtonEventType& event) -> v
 auto BouncingBall::on_mouse_button_release(const MouseButtonEventType& event) -> void
 {
     if(event.button == SDL_BUTTON_LEFT) {
-        auto& poly(*_poly);
-        auto& ball(*_ball);
-        poly.set_frozen(false);
-        ball.set_frozen(false);
+        drag(Command{CommandType::RELEASE, Pos2f(), Vec2f(), 0.0f, event.timestamp});
     }
 }
 
@@ -322,11 +1079,25 @@ auto BouncingBall::on_mouse_wheel(const MouseWheelEventType& event) -> void
 {
     const auto mods = ::SDL_GetModState();
 
-    if(mods & (KMOD_LSHIFT | KMOD_RSHIFT)) {
-        set_ball_radius(_ball->radius() + (float(event.y * 100) * _dtime));
+    /*
+     * the zoom is centered on the pointer, by a fixed factor per notch
+     */
+    auto zoom = [&]() -> void
+    {
+        int x = 0;
+        int y = 0;
+        ::SDL_GetMouseState(&x, &y);
+        _canvas->camera().zoom_at(float(x), float(y), ::powf(zoom_step, float(event.y)));
+    };
+
+    if(mods & (KMOD_LCTRL | KMOD_RCTRL)) {
+        zoom();
+    }
+    else if(mods & (KMOD_LSHIFT | KMOD_RSHIFT)) {
+        dispatch(Command{CommandType::ADD_BALL_RADIUS, Pos2f(), Vec2f(), (float(event.y * 100) * _dtime), event.timestamp});
     }
     else {
-        set_poly_radius(_poly->radius() + (float(event.y * 100) * _dtime));
+        dispatch(Command{CommandType::ADD_POLY_RADIUS, Pos2f(), Vec2f(), (float(event.y * 100) * _dtime), event.timestamp});
     }
 }
 
@@ -18,7 +18,73 @@
 #define __BouncingBall_h__
 
 #include "application.h"
-#include "objects.h"
+#include "world.h"
+#include "particles.h"
+#include "trails.h"
+#include "heatmap.h"
+#include "concurrent.h"
+#include "latency.h"
+#include "quality.h"
+
+// ---------------------------------------------------------------------------
+// CommandType
+// ---------------------------------------------------------------------------
+
+struct CommandType
+{
+    static constexpr int RESET             = 0;
+    static constexpr int RESIZE            = 1;
+    static constexpr int ADD_POLY_VERTICES = 2;
+    static constexpr int ADD_POLY_RADIUS   = 3;
+    static constexpr int ADD_POLY_OMEGA    = 4;
+    static constexpr int ADD_BALL_RADIUS   = 5;
+    static constexpr int MOVE_POLY         = 6;
+    static constexpr int MOVE_BALL         = 7;
+    static constexpr int RELEASE           = 8;
+    static constexpr int SET_TIME_SCALE    = 9;
+    static constexpr int SET_QUALITY       = 10;
+    static constexpr int SET_HEATMAP       = 11;
+};
+
+// ---------------------------------------------------------------------------
+// Command
+//
+// user input translated into a change of the simulation, so that it can be
+// handed over to the simulation thread instead of being applied in place.
+// The vector is the velocity of the MOVE commands and the new size of the
+// RESIZE command and the substep rate and solver iterations of the SET_QUALITY
+// command, the value is the amount of the ADD commands or the new time scale
+// of the SET_TIME_SCALE command or whether the SET_HEATMAP command enables the
+// recording of the occupancy. The timestamp is the one of the originating
+// event, in SDL ticks.
+// ---------------------------------------------------------------------------
+
+struct Command
+{
+    int      type;
+    Pos2f    position;
+    Vec2f    vector;
+    float    value;
+    uint32_t timestamp;
+};
+
+// ---------------------------------------------------------------------------
+// Snapshot
+//
+// copy of the simulation published by the simulation thread for rendering,
+// along with the contacts that occurred and the occupancy recorded since the
+// last acquired snapshot and the timestamp of the oldest input applied since
+// then (-1 if none).
+// ---------------------------------------------------------------------------
+
+struct Snapshot
+{
+    World                world;
+    std::vector<Contact> contacts;
+    Occupancy            occupancy;
+    uint64_t             steps;
+    int64_t              input;
+};
 
 // ---------------------------------------------------------------------------
 // BouncingBall
@@ -34,7 +100,9 @@ public: // public interface
 
     BouncingBall& operator=(const BouncingBall&) = delete;
 
-    virtual ~BouncingBall() = default;
+    virtual ~BouncingBall();
+
+    auto headless(std::ostream& stream) -> void;
 
 protected: // protected interface
     virtual auto update() -> void override final;
@@ -43,6 +111,10 @@ protected: // protected interface
 
     virtual auto shutdown() -> void override final;
 
+    virtual auto stats(std::ostream&) -> void override final;
+
+    virtual auto idle() -> bool override final;
+
     virtual auto on_quit(const QuitEventType&) -> void override final;
 
     virtual auto on_window(const WindowEventType&) -> void override final;
@@ -70,6 +142,10 @@ private: // private interface
 
     auto toggle_overlay() -> void;
 
+    auto toggle_heatmap() -> void;
+
+    auto cycle_present_mode() -> void;
+
     auto set_poly_vertices(int vertices) -> void;
 
     auto set_poly_radius(float radius) -> void;
@@ -78,15 +154,85 @@ private: // private interface
 
     auto set_ball_radius(float radius) -> void;
 
+    auto set_time_scale(float time_scale, uint32_t timestamp) -> void;
+
     auto resized(int width, int height) -> void;
 
+    auto checksum() const -> uint64_t;
+
+    auto scene() -> World&;
+
+    auto occupancy() -> Occupancy&;
+
+    auto step(Arena& arena, Occupancy& occupancy, const float dt, const int count) -> Contacts;
+
+    auto scaled_steps() -> int;
+
+    auto update_caption() -> void;
+
+    auto update_quality() -> void;
+
+    auto dispatch(const Command& command) -> void;
+
+    auto apply(const Command& command) -> void;
+
+    auto apply_commands(double ticks) -> bool;
+
+    auto drag(const Command& command) -> void;
+
+    auto latch() -> void;
+
+    auto start_thread() -> void;
+
+    auto stop_thread() -> void;
+
+    auto run_thread() -> void;
+
 private: // private data
-    std::unique_ptr<Canvas> _canvas;
-    std::unique_ptr<Poly>   _poly;
-    std::unique_ptr<Ball>   _ball;
-    Vec2f                   _size;
-    Pos2f                   _center;
-    Col4i                   _color;
+    std::unique_ptr<Canvas>            _canvas;
+    World                              _world;
+    Particles                          _particles;
+    Trails                             _trails;
+    Heatmap                            _heatmap;
+    bool                               _show_heatmap;
+    Occupancy                          _occupancy;
+    bool                               _record_heatmap;
+    Vec2f                              _size;
+    Pos2f                              _center;
+    Col4i                              _color;
+    std::atomic<uint64_t>              _contacts;
+    SpscQueue<Command, 256>            _commands;
+    TripleBuffer<Snapshot>             _snapshots;
+    std::thread                        _thread;
+    std::atomic<bool>                  _thread_quit;
+    Arena                              _thread_arena;
+    std::vector<Pos2f>                 _rendered;
+    Command                            _pending;
+    bool                               _has_pending;
+    double                             _ticks;
+    bool                               _simulated;
+    Latency                            _latency;
+    int64_t                            _applied_input;
+    int64_t                            _input_time;
+    float                              _sim_scale;
+    float                              _sim_budget;
+    std::atomic<uint64_t>              _sim_steps;
+    uint64_t                           _caption_steps;
+    uint32_t                           _caption_time;
+    double                             _sim_rate;
+    Command                            _drag;
+    Pos2f                              _drag_anchor;
+    uint32_t                           _drag_time;
+    Vec2f                              _latch_poly;
+    Vec2f                              _latch_ball;
+    Quality                            _quality;
+    uint64_t                           _frame_start;
+    float                              _substep_dtime;
+    double                             _substep_ticks;
+    int                                _iterations;
+    std::atomic<uint64_t>              _jitter_sum;
+    std::atomic<uint64_t>              _jitter_max;
+    std::atomic<uint64_t>              _jitter_count;
 };
 
 // ---------------------------------------------------------------------------
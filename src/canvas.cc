@@ -24,8 +24,12 @@
 #include <cstdint>
 #include <cstdarg>
 #include <cmath>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,7 +38,399 @@
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
+#include "globals.h"
 #include "canvas.h"
+#include "raster.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::constants
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int   min_circle_segments = 8;
+constexpr int   max_circle_segments = 96;
+constexpr int   atlas_size          = 1024;
+constexpr int   min_sprite_size     = 16;
+constexpr int   max_sprite_size     = 512;
+constexpr int   capsule_vertices    = 8;
+constexpr int   capsule_indices     = 18;
+constexpr float line_radius         = 0.5f;
+constexpr int   dirty_cell_size     = 32;
+constexpr int   dirty_max_rects     = 64;
+constexpr float dirty_max_area      = 0.5f;
+constexpr int   default_rate        = 60;
+constexpr float min_zoom            = 0.01f;
+constexpr float max_zoom            = 16.0f;
+constexpr float point_radius        = 0.5f;
+
+auto pack(const Col4i& color) -> uint32_t
+{
+    return (uint32_t(color.r) << 24) | (uint32_t(color.g) << 16) | (uint32_t(color.b) << 8) | uint32_t(color.a);
+}
+
+auto unpack(uint32_t color) -> SDL_Color
+{
+    return SDL_Color{ uint8_t(color >> 24), uint8_t(color >> 16), uint8_t(color >> 8), uint8_t(color) };
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// SpriteCache
+// ---------------------------------------------------------------------------
+
+SpriteCache::SpriteCache()
+    : _atlas(nullptr)
+    , _sprites()
+    , _shelves()
+    , _pixels()
+    , _top(0)
+    , _last(-1)
+    , _misses(0)
+    , _evictions(0)
+{
+    _sprites.reserve((atlas_size / min_sprite_size) * (atlas_size / min_sprite_size));
+    _shelves.reserve(atlas_size / min_sprite_size);
+    _pixels.reserve(max_sprite_size * max_sprite_size * 4);
+}
+
+auto SpriteCache::create(RendererType* renderer) -> void
+{
+    if(bool(_atlas) == false) {
+        _atlas.reset(::SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, atlas_size, atlas_size));
+    }
+    if(bool(_atlas) == false) {
+        throw std::runtime_error("SDL_CreateTexture() has failed");
+    }
+    if(::SDL_SetTextureBlendMode(_atlas.get(), SDL_BLENDMODE_BLEND) != 0) {
+        throw std::runtime_error("SDL_SetTextureBlendMode() has failed");
+    }
+    ::SDL_SetTextureScaleMode(_atlas.get(), SDL_ScaleModeLinear);
+}
+
+/*
+ * drops the atlas along with the sprites, before the renderer that owns the
+ * texture is destroyed, the sprites being rasterized again on a miss
+ */
+auto SpriteCache::reset() -> void
+{
+    _atlas.reset();
+    _sprites.clear();
+    _shelves.clear();
+    _top  = 0;
+    _last = -1;
+}
+
+/*
+ * returns the sprite of the given radius and color, rasterizing it on a
+ * miss, or nullptr when it does not fit in the atlas. The last hit is tried
+ * first, since consecutive lookups are usually for the same sprite.
+ */
+auto SpriteCache::find(int radius, uint32_t color, uint64_t frame) -> const Sprite*
+{
+    auto matches = [&](const Sprite& sprite) -> bool
+    {
+        return (sprite.radius == radius) && (sprite.color == color);
+    };
+
+    auto hit = [&](int index) -> const Sprite*
+    {
+        _last = index;
+        _sprites[index].frame = frame;
+        return &_sprites[index];
+    };
+
+    if((_last >= 0) && (matches(_sprites[_last]) != false)) {
+        return hit(_last);
+    }
+    for(int index = 0; index < int(_sprites.size()); ++index) {
+        if(matches(_sprites[index]) != false) {
+            return hit(index);
+        }
+    }
+    int size = min_sprite_size;
+    while(size < ((2 * radius) + 2)) {
+        size *= 2;
+    }
+    if(size > max_sprite_size) {
+        return nullptr;
+    }
+    Sprite* sprite = allocate(size, frame);
+    if(sprite == nullptr) {
+        return nullptr;
+    }
+    sprite->radius = radius;
+    sprite->color  = color;
+    rasterize(*sprite);
+    ++_misses;
+    return hit(int(sprite - _sprites.data()));
+}
+
+/*
+ * takes a free cell of a shelf of the given size, then a new shelf, then
+ * the least recently used sprite of that size not drawn during the frame.
+ * When the shelves of the other sizes fill the atlas and none of the
+ * sprites was drawn during the frame, the whole atlas is recycled.
+ */
+auto SpriteCache::allocate(int size, uint64_t frame) -> Sprite*
+{
+    auto in_use = [&]() -> bool
+    {
+        for(auto& sprite : _sprites) {
+            if(sprite.frame >= frame) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto recycle = [&]() -> void
+    {
+        _evictions += _sprites.size();
+        _sprites.clear();
+        _shelves.clear();
+        _top  = 0;
+        _last = -1;
+    };
+
+    auto add = [&](SpriteShelf& shelf) -> Sprite*
+    {
+        _sprites.push_back(Sprite{0, 0, size, RectType{(shelf.count * size), shelf.y, size, size}, frame});
+        ++shelf.count;
+        return &_sprites.back();
+    };
+
+    for(auto& shelf : _shelves) {
+        if((shelf.size == size) && (((shelf.count + 1) * size) <= atlas_size)) {
+            return add(shelf);
+        }
+    }
+    if((_top + size) <= atlas_size) {
+        _shelves.push_back(SpriteShelf{_top, size, 0});
+        _top += size;
+        return add(_shelves.back());
+    }
+    Sprite* oldest = nullptr;
+    for(auto& sprite : _sprites) {
+        if((sprite.size == size) && (sprite.frame < frame) && ((oldest == nullptr) || (sprite.frame < oldest->frame))) {
+            oldest = &sprite;
+        }
+    }
+    if(oldest != nullptr) {
+        oldest->frame = frame;
+        ++_evictions;
+        return oldest;
+    }
+    if((_sprites.empty() == false) && (in_use() == false)) {
+        recycle();
+        return allocate(size, frame);
+    }
+    return nullptr;
+}
+
+/*
+ * draws the disc centered in its cell with an anti-aliased edge, the color
+ * is set on every texel so that the filtering does not darken the edge
+ */
+auto SpriteCache::rasterize(const Sprite& sprite) -> void
+{
+    const int       size   = sprite.size;
+    const float     center = float(sprite.radius + 1);
+    const float     radius = float(sprite.radius) + 0.5f;
+    const SDL_Color color(unpack(sprite.color));
+
+    _pixels.resize(size * size * 4);
+    uint8_t* pixel = _pixels.data();
+    for(int y = 0; y < size; ++y) {
+        const float dy = (float(y) + 0.5f - center);
+        for(int x = 0; x < size; ++x) {
+            const float dx       = (float(x) + 0.5f - center);
+            const float coverage = std::max(0.0f, std::min(1.0f, (radius - ::sqrtf((dx * dx) + (dy * dy)))));
+            *pixel++ = color.r;
+            *pixel++ = color.g;
+            *pixel++ = color.b;
+            *pixel++ = uint8_t(float(color.a) * coverage);
+        }
+    }
+    ::SDL_UpdateTexture(_atlas.get(), &sprite.cell, _pixels.data(), (size * 4));
+}
+
+// ---------------------------------------------------------------------------
+// DirtyRegion
+// ---------------------------------------------------------------------------
+
+DirtyRegion::DirtyRegion()
+    : _width(0)
+    , _height(0)
+    , _cols(0)
+    , _rows(0)
+    , _cells()
+    , _rects()
+    , _invalid(true)
+    , _area(1.0f)
+{
+    _rects.reserve(dirty_max_rects);
+}
+
+/*
+ * sizes the grid for a window of the given size, the content of the frame
+ * being lost along with the previous render target
+ */
+auto DirtyRegion::resize(int width, int height) -> void
+{
+    if((width != _width) || (height != _height)) {
+        _width  = width;
+        _height = height;
+        _cols   = ((width  + dirty_cell_size - 1) / dirty_cell_size);
+        _rows   = ((height + dirty_cell_size - 1) / dirty_cell_size);
+        _cells.assign((_cols * _rows), 0);
+    }
+    invalidate();
+}
+
+auto DirtyRegion::invalidate() -> void
+{
+    _invalid = true;
+}
+
+/*
+ * marks the cells overlapped by the given bounds for the current frame
+ */
+auto DirtyRegion::add(float x0, float y0, float x1, float y1) -> void
+{
+    const int col0 = int(std::max(0.0f, x0)) / dirty_cell_size;
+    const int row0 = int(std::max(0.0f, y0)) / dirty_cell_size;
+    const int col1 = std::min((_cols - 1), (int(std::max(0.0f, x1)) / dirty_cell_size));
+    const int row1 = std::min((_rows - 1), (int(std::max(0.0f, y1)) / dirty_cell_size));
+
+    for(int row = row0; row <= row1; ++row) {
+        uint8_t* cell = &_cells[(row * _cols) + col0];
+        for(int col = col0; col <= col1; ++col) {
+            *cell++ |= 1;
+        }
+    }
+}
+
+/*
+ * merges the cells marked by the previous and the current frames into
+ * rectangles, the runs of a row extending the rectangles of the row above
+ * when they span the same columns, then hands the marks of the current
+ * frame over to the next one. Returns false when the whole frame has to
+ * be redrawn.
+ */
+auto DirtyRegion::update() -> bool
+{
+    int  dirty    = 0;
+    bool overflow = false;
+
+    auto add_run = [&](int row, int col0, int col1) -> void
+    {
+        const int x = (col0 * dirty_cell_size);
+        const int y = (row  * dirty_cell_size);
+        const int w = (std::min(_width,  (col1 * dirty_cell_size)) - x);
+        const int h = (std::min(_height, (y + dirty_cell_size)) - y);
+        for(auto& rect : _rects) {
+            if((rect.x == x) && (rect.w == w) && ((rect.y + rect.h) == y)) {
+                rect.h += h;
+                return;
+            }
+        }
+        if(int(_rects.size()) < dirty_max_rects) {
+            _rects.push_back(RectType{x, y, w, h});
+        }
+        else {
+            overflow = true;
+        }
+    };
+
+    _rects.clear();
+    if(_cells.empty() != false) {
+        return false;
+    }
+    for(int row = 0; row < _rows; ++row) {
+        uint8_t* cells = &_cells[row * _cols];
+        int      first = -1;
+        for(int col = 0; col < _cols; ++col) {
+            const bool marked = (cells[col] != 0);
+            cells[col] = ((cells[col] & 1) << 1);
+            if(marked != false) {
+                ++dirty;
+                if(first < 0) {
+                    first = col;
+                }
+            }
+            else if(first >= 0) {
+                add_run(row, first, col);
+                first = -1;
+            }
+        }
+        if(first >= 0) {
+            add_run(row, first, _cols);
+        }
+    }
+    _area = (float(dirty) / float(_cols * _rows));
+    if((_invalid != false) || (overflow != false) || (_area > dirty_max_area)) {
+        _invalid = false;
+        _area    = 1.0f;
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Camera
+// ---------------------------------------------------------------------------
+
+Camera::Camera()
+    : _width(0.0f)
+    , _height(0.0f)
+    , _center_x(0.0f)
+    , _center_y(0.0f)
+    , _pan_x(0.0f)
+    , _pan_y(0.0f)
+    , _zoom(1.0f)
+{
+}
+
+auto Camera::resize(int width, int height) -> void
+{
+    _width    = float(width);
+    _height   = float(height);
+    _center_x = (_width  * 0.5f);
+    _center_y = (_height * 0.5f);
+}
+
+auto Camera::reset() -> void
+{
+    _pan_x = 0.0f;
+    _pan_y = 0.0f;
+    _zoom  = 1.0f;
+}
+
+/*
+ * moves the view by the given amount of window pixels, the world following
+ * the pointer
+ */
+auto Camera::pan(float dx, float dy) -> void
+{
+    _pan_x -= (dx / _zoom);
+    _pan_y -= (dy / _zoom);
+}
+
+/*
+ * scales the view by the given factor, keeping the world point under the
+ * given window position in place
+ */
+auto Camera::zoom_at(float x, float y, float factor) -> void
+{
+    const float world_x = to_world_x(x);
+    const float world_y = to_world_y(y);
+
+    _zoom  = std::max(min_zoom, std::min(max_zoom, (_zoom * factor)));
+    _pan_x = (world_x - _center_x - ((x - _center_x) / _zoom));
+    _pan_y = (world_y - _center_y - ((y - _center_y) / _zoom));
+}
 
 // ---------------------------------------------------------------------------
 // Canvas
@@ -46,12 +442,52 @@ Canvas::Canvas(const std::string& title, const int width, const int height)
     , _renderer(nullptr)
     , _underlay(nullptr)
     , _overlay(nullptr)
+    , _target(nullptr)
+    , _target_w(0)
+    , _target_h(0)
+    , _background_layer()
+    , _overlay_layer()
+    , _heatmap(nullptr)
+    , _heatmap_w(0)
+    , _heatmap_h(0)
+    , _heatmap_cell(0.0f)
+    , _heatmap_rect{0, 0, 0, 0}
+    , _raster(nullptr)
+    , _framebuffer(nullptr)
+    , _framebuffer_w(0)
+    , _framebuffer_h(0)
+    , _background(0)
+    , _pending(false)
+    , _resolution(1.0f)
+    , _circle_lod(1)
+    , _color()
+    , _camera()
+    , _shapes()
+    , _vertices()
+    , _indices()
+    , _rects()
+    , _commands()
+    , _draw_calls(0)
+    , _frame_draw_calls(0)
+    , _sprites()
+    , _dirty()
+    , _restored(0)
+    , _refresh_rate(default_rate)
+    , _present_time(0)
+    , _present_deadline(0)
+    , _presented(0)
+    , _dropped(0)
+    , _frame(0)
     , _show_underlay(true)
     , _show_overlay(false)
 {
     create(width, height);
 }
 
+Canvas::~Canvas()
+{
+}
+
 auto Canvas::create(const int width, const int height) -> void
 {
     auto create_drawable = [&]() -> void
@@ -73,7 +509,8 @@ auto Canvas::create(const int width, const int height) -> void
     auto create_renderer = [&]() -> void
     {
         const int      index = -1;
-        const uint32_t flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+        const uint32_t vsync = (Globals::present_mode == PresentType::VSYNC ? SDL_RENDERER_PRESENTVSYNC : 0);
+        const uint32_t flags = SDL_RENDERER_ACCELERATED | vsync;
 
         if(bool(_renderer) == false) {
             _renderer.reset(::SDL_CreateRenderer(_drawable.get(), index, flags));
@@ -81,6 +518,9 @@ auto Canvas::create(const int width, const int height) -> void
         if(bool(_renderer) == false) {
             throw std::runtime_error("SDL_CreateRenderer() has failed");
         }
+        if(::SDL_SetRenderDrawBlendMode(_renderer.get(), SDL_BLENDMODE_BLEND) != 0) {
+            throw std::runtime_error("SDL_SetRenderDrawBlendMode() has failed");
+        }
     };
 
     auto create_underlay = [&]() -> void
@@ -103,12 +543,58 @@ auto Canvas::create(const int width, const int height) -> void
         }
     };
 
+    auto create_sprites = [&]() -> void
+    {
+        _sprites.create(_renderer.get());
+    };
+
+    auto query_refresh = [&]() -> void
+    {
+        SDL_DisplayMode mode;
+        if((::SDL_GetWindowDisplayMode(_drawable.get(), &mode) == 0) && (mode.refresh_rate > 0)) {
+            _refresh_rate = mode.refresh_rate;
+        }
+    };
+
+    /*
+     * the software rasterizer composites the underlay and the overlay by
+     * itself, from images in the pixel format of its framebuffer
+     */
+    auto create_raster = [&]() -> void
+    {
+        auto load = [&](const char* path) -> std::unique_ptr<SurfaceType>
+        {
+            std::unique_ptr<SurfaceType> image(::IMG_Load(path));
+            if(bool(image) == false) {
+                throw std::runtime_error("IMG_Load() has failed");
+            }
+            std::unique_ptr<SurfaceType> surface(::SDL_ConvertSurfaceFormat(image.get(), SDL_PIXELFORMAT_ARGB8888, 0));
+            if(bool(surface) == false) {
+                throw std::runtime_error("SDL_ConvertSurfaceFormat() has failed");
+            }
+            return surface;
+        };
+
+        if(bool(_raster) == false) {
+            _raster.reset(new Raster(::SDL_GetCPUCount()));
+            _raster->set_underlay(load("assets/underlay.png").get());
+            _raster->set_overlay(load("assets/overlay.png").get());
+        }
+    };
+
     auto do_create = [&]() -> void
     {
         create_drawable();
         create_renderer();
-        create_underlay();
-        create_overlay();
+        if(Globals::software != false) {
+            create_raster();
+        }
+        else {
+            create_underlay();
+            create_overlay();
+        }
+        create_sprites();
+        query_refresh();
     };
 
     do_create();
@@ -116,29 +602,302 @@ auto Canvas::create(const int width, const int height) -> void
 
 auto Canvas::clear() -> void
 {
+    /*
+     * below full resolution, the frame is drawn into a smaller target with
+     * the matching scale and stretched to the window by present(). With the
+     * dirty rectangles, the target is kept at any resolution, since it holds
+     * the previous frame.
+     */
+    auto bind_target = [&](RendererType* renderer) -> void
+    {
+        int output_w = 0;
+        int output_h = 0;
+        if(((_resolution >= 1.0f) && (Globals::dirty_rects == false)) || (::SDL_GetRendererOutputSize(renderer, &output_w, &output_h) != 0)) {
+            return;
+        }
+        const int target_w = std::max(1, int(float(output_w) * _resolution));
+        const int target_h = std::max(1, int(float(output_h) * _resolution));
+        if((bool(_target) == false) || (target_w != _target_w) || (target_h != _target_h)) {
+            _target.reset(::SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, target_w, target_h));
+            _target_w = target_w;
+            _target_h = target_h;
+            _dirty.resize(output_w, output_h);
+        }
+        if(bool(_target) != false) {
+            ::SDL_SetRenderTarget(renderer, _target.get());
+            ::SDL_RenderSetScale(renderer, (float(target_w) / float(output_w)), (float(target_h) / float(output_h)));
+        }
+    };
+
+    /*
+     * the heatmap covers the world from its origin, its rectangle in the
+     * pixels of the layer following the camera
+     */
+    auto heatmap_rect = [&](int width, int height) -> RectType
+    {
+        if((bool(_heatmap) == false) || (_camera.width() <= 0.0f) || (_camera.height() <= 0.0f)) {
+            return RectType{0, 0, 0, 0};
+        }
+        const float scale_x = (float(width)  / _camera.width());
+        const float scale_y = (float(height) / _camera.height());
+        const int   x0      = int(::floorf(_camera.to_screen_x(0.0f) * scale_x));
+        const int   y0      = int(::floorf(_camera.to_screen_y(0.0f) * scale_y));
+        const int   x1      = int(::ceilf(_camera.to_screen_x(float(_heatmap_w) * _heatmap_cell) * scale_x));
+        const int   y1      = int(::ceilf(_camera.to_screen_y(float(_heatmap_h) * _heatmap_cell) * scale_y));
+        return RectType{x0, y0, (x1 - x0), (y1 - y0)};
+    };
+
+    auto draw_heatmap = [&](RendererType* renderer, const RectType& rect) -> void
+    {
+        TextureType* target  = ::SDL_GetRenderTarget(renderer);
+        float        scale_x = 1.0f;
+        float        scale_y = 1.0f;
+        ::SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+        ::SDL_SetRenderTarget(renderer, _background_layer.texture.get());
+        ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+        ::SDL_RenderCopy(renderer, _heatmap.get(), nullptr, &rect);
+        ::SDL_SetRenderTarget(renderer, target);
+        ::SDL_RenderSetScale(renderer, scale_x, scale_y);
+        ++_draw_calls;
+    };
+
+    /*
+     * the background color, the underlay and the heatmap are composited once
+     * into a layer of the size of the frame, which is then copied without
+     * scaling
+     */
+    auto bind_background = [&](RendererType* renderer, TextureType* texture) -> void
+    {
+        int width  = _target_w;
+        int height = _target_h;
+        if((::SDL_GetRenderTarget(renderer) == nullptr) && (::SDL_GetRendererOutputSize(renderer, &width, &height) != 0)) {
+            return;
+        }
+        const RectType rect(heatmap_rect(width, height));
+        const bool     moved = ((rect.x != _heatmap_rect.x) || (rect.y != _heatmap_rect.y) || (rect.w != _heatmap_rect.w) || (rect.h != _heatmap_rect.h));
+        if((_background_layer.stale == false) && (_background_layer.width == width) && (_background_layer.height == height) && (_background == _restored) && (moved == false)) {
+            return;
+        }
+        render_layer(renderer, _background_layer, texture, unpack(_background), width, height, SDL_BLENDMODE_NONE);
+        if(bool(_heatmap) != false) {
+            draw_heatmap(renderer, rect);
+        }
+        _heatmap_rect = rect;
+        _restored     = _background;
+        _dirty.invalidate();
+    };
+
+    auto resize_camera = [&](RendererType* renderer) -> void
+    {
+        int output_w = 0;
+        int output_h = 0;
+        if(::SDL_GetRendererOutputSize(renderer, &output_w, &output_h) == 0) {
+            _camera.resize(output_w, output_h);
+        }
+    };
+
     auto do_clear = [&](RendererType* renderer, TextureType* texture) -> void
     {
+        _draw_calls = 0;
+        _background = pack(_color);
+        if(renderer != nullptr) {
+            resize_camera(renderer);
+        }
+        if(bool(_raster) != false) {
+            _pending = true;
+            return;
+        }
         if(renderer != nullptr) {
-            ::SDL_RenderClear(renderer);
-            if(texture != nullptr) {
-                ::SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+            bind_target(renderer);
+            bind_background(renderer, texture);
+            if((Globals::dirty_rects != false) && (::SDL_GetRenderTarget(renderer) != nullptr)) {
+                _pending = true;
+                return;
             }
+            ::SDL_RenderCopy(renderer, _background_layer.texture.get(), nullptr, nullptr);
+            ++_draw_calls;
         }
     };
 
     return do_clear(_renderer.get(), (_show_underlay != false ? _underlay.get() : nullptr));
 }
 
-auto Canvas::present() -> void
+/*
+ * draws the recorded primitives, the commands are sorted by type, color and
+ * recording order, so that the draw color only changes between runs and the
+ * runs of a given type are issued back to back. The lines and the discs are
+ * recorded as shapes, expanded into geometry here, while the trails and the
+ * sprites are recorded as geometry already. The geometry is then merged into
+ * a single call for all the untextured primitives and another one for the
+ * sprites.
+ */
+auto Canvas::flush() -> void
+{
+    auto compare = [](const DrawCommand& lhs, const DrawCommand& rhs) -> bool
+    {
+        if(lhs.type != rhs.type) {
+            return lhs.type < rhs.type;
+        }
+        if(lhs.color != rhs.color) {
+            return lhs.color < rhs.color;
+        }
+        return lhs.order < rhs.order;
+    };
+
+    auto draw = [&](RendererType* renderer, const DrawCommand& command) -> void
+    {
+        switch(command.type) {
+            case DrawType::LINES:
+            case DrawType::DISCS:
+            case DrawType::TRAILS:
+                ::SDL_RenderGeometry(renderer, nullptr, _vertices.data(), int(_vertices.size()), &_indices[command.first], command.count);
+                break;
+            case DrawType::SPRITES:
+                ::SDL_RenderGeometry(renderer, _sprites.texture(), _vertices.data(), int(_vertices.size()), &_indices[command.first], command.count);
+                break;
+            case DrawType::RECTS:
+                ::SDL_RenderFillRects(renderer, &_rects[command.first], command.count);
+                break;
+            default:
+                break;
+        }
+        ++_draw_calls;
+    };
+
+    auto do_flush = [&](RendererType* renderer) -> void
+    {
+        if((renderer != nullptr) && (bool(_raster) != false)) {
+            std::sort(_commands.begin(), _commands.end(), compare);
+            rasterize(renderer);
+        }
+        else if(renderer != nullptr) {
+            std::sort(_commands.begin(), _commands.end(), compare);
+            if(_pending != false) {
+                restore(renderer);
+            }
+            expand();
+            merge();
+            uint32_t color = 0;
+            for(auto& command : _commands) {
+                const bool geometry = (command.type != DrawType::RECTS);
+                if((geometry == false) && ((&command == _commands.data()) || (command.color != color))) {
+                    const SDL_Color rgba(unpack(command.color));
+                    ::SDL_SetRenderDrawColor(renderer, rgba.r, rgba.g, rgba.b, rgba.a);
+                    color = command.color;
+                }
+                draw(renderer, command);
+            }
+        }
+        _shapes.clear();
+        _vertices.clear();
+        _indices.clear();
+        _rects.clear();
+        _commands.clear();
+    };
+
+    return do_flush(_renderer.get());
+}
+
+/*
+ * sizes the buffers for the largest expected frame, so that the recording
+ * does not allocate once the program has started
+ */
+auto Canvas::reserve(int lines, int circles, int rects, int trails) -> void
+{
+    _shapes.reserve(lines + circles);
+    _vertices.reserve((lines * capsule_vertices) + (circles * ((2 * max_circle_segments) + 1)) + (trails * 2));
+    _indices.reserve(2 * ((lines * capsule_indices) + (circles * (max_circle_segments * 9)) + (trails * 6)));
+    _rects.reserve(rects + lines + circles);
+    _commands.reserve(lines + (2 * circles) + rects);
+    if(bool(_raster) != false) {
+        _raster->reserve(lines + circles + rects + trails);
+    }
+}
+
+/*
+ * the present mode decides whether the frame waits for the vertical sync
+ * and whether it may be dropped instead. Returns whether the frame has
+ * actually been presented.
+ */
+auto Canvas::present() -> bool
 {
-    auto do_present = [&](RendererType* renderer, TextureType* texture) -> void
+    /*
+     * the overlay is stretched once into a layer of the size of the window,
+     * keeping its alpha so that it is blended when copied
+     */
+    auto bind_overlay = [&](RendererType* renderer, TextureType* texture) -> void
     {
+        int width  = 0;
+        int height = 0;
+        if(::SDL_GetRendererOutputSize(renderer, &width, &height) != 0) {
+            return;
+        }
+        if((_overlay_layer.stale == false) && (_overlay_layer.width == width) && (_overlay_layer.height == height)) {
+            return;
+        }
+        render_layer(renderer, _overlay_layer, texture, SDL_Color{0, 0, 0, 0}, width, height, SDL_BLENDMODE_BLEND);
+    };
+
+    /*
+     * with the latest frame mode, the frames are rendered ahead as fast as
+     * possible and only the latest one is presented at each refresh, those
+     * rendered in between being dropped. With the other modes, a frame is
+     * dropped whenever two presents are more than one and a half periods
+     * apart.
+     */
+    auto is_due = [&](RendererType* renderer) -> bool
+    {
+        const uint64_t now    = ::SDL_GetPerformanceCounter();
+        const int      rate   = ((Globals::present_mode == PresentType::CAPPED) && (Globals::pacing > 0) ? Globals::pacing : _refresh_rate);
+        const uint64_t period = (::SDL_GetPerformanceFrequency() / uint64_t(rate));
+        if(Globals::present_mode == PresentType::LATEST) {
+            if(now < _present_deadline) {
+                ::SDL_RenderFlush(renderer);
+                ++_dropped;
+                return false;
+            }
+            _present_deadline += period;
+            if(_present_deadline <= now) {
+                _present_deadline = (now + period);
+            }
+        }
+        else if((Globals::present_mode != PresentType::IMMEDIATE) && (_present_time != 0)) {
+            const uint64_t interval = (now - _present_time);
+            if((2 * interval) > (3 * period)) {
+                _dropped += uint32_t(((interval + (period / 2)) / period) - 1);
+            }
+        }
+        _present_time = now;
+        ++_presented;
+        return true;
+    };
+
+    auto do_present = [&](RendererType* renderer, TextureType* texture) -> bool
+    {
+        bool due = false;
+        flush();
         if(renderer != nullptr) {
-            if(texture != nullptr) {
-                ::SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+            due = is_due(renderer);
+            if(::SDL_GetRenderTarget(renderer) != nullptr) {
+                ::SDL_SetRenderTarget(renderer, nullptr);
+                ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+                if(due != false) {
+                    ::SDL_RenderCopy(renderer, _target.get(), nullptr, nullptr);
+                    ++_draw_calls;
+                }
+            }
+            if((due != false) && (texture != nullptr)) {
+                bind_overlay(renderer, texture);
+                ::SDL_RenderCopy(renderer, _overlay_layer.texture.get(), nullptr, nullptr);
+                ++_draw_calls;
+            }
+            if(due != false) {
+                ::SDL_RenderPresent(renderer);
             }
-            ::SDL_RenderPresent(renderer);
         }
+        _frame_draw_calls = _draw_calls;
+        ++_frame;
+        return due;
     };
 
     return do_present(_renderer.get(), (_show_overlay != false ? _overlay.get() : nullptr));
@@ -146,58 +905,715 @@ auto Canvas::present() -> void
 
 auto Canvas::color(const Col4i& color) -> void
 {
-    auto do_color = [&](RendererType* renderer) -> void
+    _color = color;
+}
+
+/*
+ * the line is a capsule of one pixel wide whatever the zoom, so that its
+ * ends are rounded and consecutive lines of an outline join without a gap
+ */
+auto Canvas::line(float x1, float y1, float x2, float y2) -> void
+{
+    const float sx1    = _camera.to_screen_x(x1);
+    const float sy1    = _camera.to_screen_y(y1);
+    const float sx2    = _camera.to_screen_x(x2);
+    const float sy2    = _camera.to_screen_y(y2);
+    const float extent = (line_radius + 1.0f);
+    const float x0     = (std::min(sx1, sx2) - extent);
+    const float y0     = (std::min(sy1, sy2) - extent);
+    const float x3     = (std::max(sx1, sx2) + extent);
+    const float y3     = (std::max(sy1, sy2) + extent);
+
+    auto do_line = [&]() -> void
     {
-        if(renderer != nullptr) {
-            ::SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        const int first = int(_shapes.size());
+        _shapes.push_back(Shape{sx1, sy1, sx2, sy2, line_radius});
+        _dirty.add(x0, y0, x3, y3);
+        record(DrawType::LINES, first, 1);
+    };
+
+    if(_camera.visible(x0, y0, x3, y3) == false) {
+        return;
+    }
+    return do_line();
+}
+
+auto Canvas::circle(float xc, float yc, float r) -> void
+{
+    const float sx = _camera.to_screen_x(xc);
+    const float sy = _camera.to_screen_y(yc);
+    const float sr = (r * _camera.zoom());
+
+    if(sr < point_radius) {
+        return add_point(sx, sy);
+    }
+    return add_disc(sx, sy, sr);
+}
+
+/*
+ * the disc is a textured quad from the sprite cache, or a shape when the
+ * cache cannot hold it. The atlas is filtered, so that the quad keeps the
+ * sub-pixel position of the center.
+ */
+auto Canvas::sprite(float xc, float yc, float r) -> void
+{
+    const float sx     = _camera.to_screen_x(xc);
+    const float sy     = _camera.to_screen_y(yc);
+    const float sr     = (r * _camera.zoom());
+    const int   radius = int(sr);
+    const float extent = float(radius + 1);
+    const float x0     = (sx - extent);
+    const float y0     = (sy - extent);
+    const float x1     = (sx + extent);
+    const float y1     = (sy + extent);
+
+    auto do_sprite = [&](const Sprite* sprite) -> void
+    {
+        const SDL_Color white  = { 255, 255, 255, 255 };
+        const float     scale  = (1.0f / float(atlas_size));
+        const float     u0     = (float(sprite->cell.x) * scale);
+        const float     v0     = (float(sprite->cell.y) * scale);
+        const float     u1     = (float(sprite->cell.x + (2 * radius) + 2) * scale);
+        const float     v1     = (float(sprite->cell.y + (2 * radius) + 2) * scale);
+        const int       base   = int(_vertices.size());
+        const int       first  = int(_indices.size());
+        _vertices.push_back(VertexType{SDL_FPoint{x0, y0}, white, SDL_FPoint{u0, v0}});
+        _vertices.push_back(VertexType{SDL_FPoint{x1, y0}, white, SDL_FPoint{u1, v0}});
+        _vertices.push_back(VertexType{SDL_FPoint{x1, y1}, white, SDL_FPoint{u1, v1}});
+        _vertices.push_back(VertexType{SDL_FPoint{x0, y1}, white, SDL_FPoint{u0, v1}});
+        _indices.push_back(base + 0);
+        _indices.push_back(base + 1);
+        _indices.push_back(base + 2);
+        _indices.push_back(base + 0);
+        _indices.push_back(base + 2);
+        _indices.push_back(base + 3);
+        _dirty.add((x0 - 1.0f), (y0 - 1.0f), (x1 + 1.0f), (y1 + 1.0f));
+        record(DrawType::SPRITES, first, 6);
+    };
+
+    if(sr < point_radius) {
+        return add_point(sx, sy);
+    }
+    if(_camera.visible(x0, y0, x1, y1) == false) {
+        return;
+    }
+    const Sprite* sprite = _sprites.find(radius, pack(_color), _frame);
+    if(sprite == nullptr) {
+        return add_disc(sx, sy, sr);
+    }
+    return do_sprite(sprite);
+}
+
+/*
+ * the point stands for an object smaller than a pixel at the current zoom
+ */
+auto Canvas::point(float x, float y) -> void
+{
+    return add_point(_camera.to_screen_x(x), _camera.to_screen_y(y));
+}
+
+/*
+ * the trail is a strip through the points of a ring, from the oldest one to
+ * the newest one, whose half-width and alpha grow along it up to the radius
+ * and the alpha of the current color, so that it fades out behind the ball.
+ * Each point is a pair of vertices across the strip, shared by the quads on
+ * both sides. The strip is culled as a whole from its bounding box, but its
+ * segments are marked dirty one by one, since a trail is usually a thin
+ * curve across a large box.
+ */
+auto Canvas::trail(const float* xs, const float* ys, int size, int first, int count, float r) -> void
+{
+    const float width = std::max(line_radius, (r * _camera.zoom()));
+
+    auto next = [&](int slot) -> int
+    {
+        return ((slot + 1) < size ? (slot + 1) : 0);
+    };
+
+    auto do_trail = [&]() -> void
+    {
+        const int base   = int(_vertices.size());
+        const int start  = int(_indices.size());
+        int       slot   = first;
+        float     prev_x = xs[slot];
+        float     prev_y = ys[slot];
+        float     curr_x = prev_x;
+        float     curr_y = prev_y;
+        float     last_x = 0.0f;
+        float     last_y = 0.0f;
+        for(int index = 0; index < count; ++index) {
+            slot = next(slot);
+            const float     next_x = ((index + 1) < count ? xs[slot] : curr_x);
+            const float     next_y = ((index + 1) < count ? ys[slot] : curr_y);
+            const float     dx     = (next_x - prev_x);
+            const float     dy     = (next_y - prev_y);
+            const float     length = ::sqrtf((dx * dx) + (dy * dy));
+            const float     t      = (float(index + 1) / float(count));
+            const float     w      = std::max(line_radius, (width * t));
+            const float     nx     = (length > 0.0f ? ((-dy / length) * w) : 0.0f);
+            const float     ny     = (length > 0.0f ? ((+dx / length) * w) : 0.0f);
+            const float     sx     = _camera.to_screen_x(curr_x);
+            const float     sy     = _camera.to_screen_y(curr_y);
+            const SDL_Color color  = { _color.r, _color.g, _color.b, uint8_t(float(_color.a) * t) };
+            _vertices.push_back(VertexType{SDL_FPoint{(sx + nx), (sy + ny)}, color, SDL_FPoint{0.0f, 0.0f}});
+            _vertices.push_back(VertexType{SDL_FPoint{(sx - nx), (sy - ny)}, color, SDL_FPoint{0.0f, 0.0f}});
+            if(index > 0) {
+                const int   a      = (base + (2 * (index - 1)));
+                const int   b      = (base + (2 * index));
+                const float extent = (w + 1.0f);
+                _indices.push_back(a);
+                _indices.push_back(b);
+                _indices.push_back(b + 1);
+                _indices.push_back(a);
+                _indices.push_back(b + 1);
+                _indices.push_back(a + 1);
+                _dirty.add((std::min(sx, last_x) - extent), (std::min(sy, last_y) - extent), (std::max(sx, last_x) + extent), (std::max(sy, last_y) + extent));
+            }
+            prev_x = curr_x;
+            prev_y = curr_y;
+            curr_x = next_x;
+            curr_y = next_y;
+            last_x = sx;
+            last_y = sy;
         }
+        record(DrawType::TRAILS, start, (int(_indices.size()) - start));
     };
 
-    return do_color(_renderer.get());
+    auto visible = [&]() -> bool
+    {
+        int   slot  = first;
+        float min_x = xs[slot];
+        float min_y = ys[slot];
+        float max_x = min_x;
+        float max_y = min_y;
+        for(int index = 1; index < count; ++index) {
+            slot  = next(slot);
+            min_x = std::min(min_x, xs[slot]);
+            min_y = std::min(min_y, ys[slot]);
+            max_x = std::max(max_x, xs[slot]);
+            max_y = std::max(max_y, ys[slot]);
+        }
+        const float extent = (width + 1.0f);
+        return _camera.visible((_camera.to_screen_x(min_x) - extent), (_camera.to_screen_y(min_y) - extent), (_camera.to_screen_x(max_x) + extent), (_camera.to_screen_y(max_y) + extent));
+    };
+
+    if((count < 2) || (visible() == false)) {
+        return;
+    }
+    return do_trail();
 }
 
-auto Canvas::line(int x1, int y1, int x2, int y2) -> void
+/*
+ * the rectangles are scaled by the zoom, keeping at least one pixel
+ */
+auto Canvas::fill_rects(const RectType* rects, int count) -> void
 {
-    auto do_line = [&](RendererType* renderer) -> void
+    const int first = int(_rects.size());
+
+    auto add_rect = [&](const RectType& rect) -> void
     {
-        if(renderer != nullptr) {
-            ::SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+        const float x0 = _camera.to_screen_x(float(rect.x));
+        const float y0 = _camera.to_screen_y(float(rect.y));
+        const float x1 = _camera.to_screen_x(float(rect.x + rect.w));
+        const float y1 = _camera.to_screen_y(float(rect.y + rect.h));
+        if(_camera.visible(x0, y0, x1, y1) != false) {
+            _rects.push_back(RectType{int(::floorf(x0)), int(::floorf(y0)), std::max(1, int(x1 - x0)), std::max(1, int(y1 - y0))});
+            _dirty.add((x0 - 1.0f), (y0 - 1.0f), (x1 + 1.0f), (y1 + 1.0f));
         }
     };
 
-    return do_line(_renderer.get());
+    auto do_fill_rects = [&]() -> void
+    {
+        for(int index = 0; index < count; ++index) {
+            add_rect(rects[index]);
+        }
+        if(int(_rects.size()) > first) {
+            record(DrawType::RECTS, first, (int(_rects.size()) - first));
+        }
+    };
+
+    return do_fill_rects();
+}
+
+/*
+ * tells whether the given bounds, in world coordinates, overlap the view
+ */
+auto Canvas::visible(float x0, float y0, float x1, float y1) const -> bool
+{
+    return _camera.visible(_camera.to_screen_x(x0), _camera.to_screen_y(y0), _camera.to_screen_x(x1), _camera.to_screen_y(y1));
+}
+
+/*
+ * tells whether an object of the given radius, in world units, is smaller
+ * than a pixel at the current zoom and has to be drawn as a point
+ */
+auto Canvas::subpixel(float radius) const -> bool
+{
+    return (radius * _camera.zoom()) < point_radius;
+}
+
+/*
+ * appends a range of primitives to the last command when it has the same
+ * type and color, the ranges being contiguous, or starts a new command
+ */
+auto Canvas::record(int type, int first, int count) -> void
+{
+    const uint32_t color = pack(_color);
+
+    if(_commands.empty() == false) {
+        DrawCommand& last(_commands.back());
+        if((last.type == type) && (last.color == color) && ((last.first + last.count) == first)) {
+            last.count += count;
+            return;
+        }
+    }
+    _commands.push_back(DrawCommand{type, color, first, count, int(_commands.size())});
 }
 
-auto Canvas::circle(int xc, int yc, int r) -> void
+/*
+ * restores the background of the frame kept in the render target over the
+ * dirty region, or over the whole frame when it has to be redrawn, before
+ * the primitives are drawn. The rectangles are copied from the background
+ * layer pixel for pixel, rounded outwards to the pixels of the target.
+ */
+auto Canvas::restore(RendererType* renderer) -> void
 {
-    auto do_circle = [&](RendererType* renderer) -> void
+    TextureType* background = _background_layer.texture.get();
+
+    auto restore_frame = [&]() -> void
     {
-        if(renderer != nullptr) {
-            int x = 0;
-            int y = r;
-            int m = (5 - (4 * r));
-            while(x <= y) {
-                const int x1 = (xc - x);
-                const int x2 = (xc + x);
-                const int x3 = (xc - y);
-                const int x4 = (xc + y);
-                const int y1 = (yc - y);
-                const int y2 = (yc + y);
-                const int y3 = (yc - x);
-                const int y4 = (yc + x);
-                ::SDL_RenderDrawLine(renderer, x1, y1, x2, y1);
-                ::SDL_RenderDrawLine(renderer, x1, y2, x2, y2);
-                ::SDL_RenderDrawLine(renderer, x3, y3, x4, y3);
-                ::SDL_RenderDrawLine(renderer, x3, y4, x4, y4);
-                if(m > 0) {
-                    m -= (8 * --y);
+        ::SDL_RenderCopy(renderer, background, nullptr, nullptr);
+        ++_draw_calls;
+    };
+
+    auto restore_rects = [&](const std::vector<RectType>& rects) -> void
+    {
+        const float scale_x = (float(_background_layer.width)  / float(_dirty.width()));
+        const float scale_y = (float(_background_layer.height) / float(_dirty.height()));
+        float       render_x = 1.0f;
+        float       render_y = 1.0f;
+        ::SDL_RenderGetScale(renderer, &render_x, &render_y);
+        ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+        for(auto& rect : rects) {
+            const int x0 = int(::floorf(float(rect.x) * scale_x));
+            const int y0 = int(::floorf(float(rect.y) * scale_y));
+            const int x1 = int(::ceilf(float(rect.x + rect.w) * scale_x));
+            const int y1 = int(::ceilf(float(rect.y + rect.h) * scale_y));
+            const RectType pixels = { x0, y0, (x1 - x0), (y1 - y0) };
+            ::SDL_RenderCopy(renderer, background, &pixels, &pixels);
+            ++_draw_calls;
+        }
+        ::SDL_RenderSetScale(renderer, render_x, render_y);
+    };
+
+    if(_dirty.update() != false) {
+        restore_rects(_dirty.rects());
+    }
+    else {
+        restore_frame();
+    }
+    _pending = false;
+}
+
+/*
+ * draws a static layer into a render target of the given size, filled with
+ * the given color then covered by the source texture stretched to it, so
+ * that the scaling and the filtering are paid once and not every frame. An
+ * opaque layer composites the source over the color, a blended one copies
+ * it as is so that its alpha is applied only once.
+ */
+auto Canvas::render_layer(RendererType* renderer, StaticLayer& layer, TextureType* source, const SDL_Color& color, int width, int height, SDL_BlendMode mode) -> void
+{
+    TextureType* target  = ::SDL_GetRenderTarget(renderer);
+    float        scale_x = 1.0f;
+    float        scale_y = 1.0f;
+
+    if((bool(layer.texture) == false) || (width != layer.width) || (height != layer.height)) {
+        layer.texture.reset(::SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height));
+        layer.width  = width;
+        layer.height = height;
+    }
+    if(bool(layer.texture) == false) {
+        throw std::runtime_error("SDL_CreateTexture() has failed");
+    }
+    if(::SDL_SetTextureBlendMode(layer.texture.get(), mode) != 0) {
+        throw std::runtime_error("SDL_SetTextureBlendMode() has failed");
+    }
+    ::SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+    ::SDL_SetRenderTarget(renderer, layer.texture.get());
+    ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+    ::SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    ::SDL_RenderClear(renderer);
+    if(source != nullptr) {
+        SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+        ::SDL_GetTextureBlendMode(source, &blend);
+        ::SDL_SetTextureBlendMode(source, (mode == SDL_BLENDMODE_NONE ? blend : SDL_BLENDMODE_NONE));
+        ::SDL_RenderCopy(renderer, source, nullptr, nullptr);
+        ::SDL_SetTextureBlendMode(source, blend);
+        ++_draw_calls;
+    }
+    ::SDL_SetRenderTarget(renderer, target);
+    ::SDL_RenderSetScale(renderer, scale_x, scale_y);
+    layer.stale = false;
+}
+
+auto Canvas::add_disc(float xc, float yc, float r) -> void
+{
+    const float extent = (r + 1.0f);
+
+    if(_camera.visible((xc - extent), (yc - extent), (xc + extent), (yc + extent)) != false) {
+        const int first = int(_shapes.size());
+        _shapes.push_back(Shape{xc, yc, xc, yc, r});
+        _dirty.add((xc - extent), (yc - extent), (xc + extent), (yc + extent));
+        record(DrawType::DISCS, first, 1);
+    }
+}
+
+auto Canvas::add_point(float x, float y) -> void
+{
+    if(_camera.visible(x, y, x, y) != false) {
+        const int first = int(_rects.size());
+        _rects.push_back(RectType{int(::floorf(x)), int(::floorf(y)), 1, 1});
+        _dirty.add((x - 1.0f), (y - 1.0f), (x + 1.0f), (y + 1.0f));
+        record(DrawType::RECTS, first, 1);
+    }
+}
+
+/*
+ * turns the shapes into geometry, the command ranges becoming ranges of the
+ * indices. The opaque core of a shape is surrounded by a strip fading from
+ * its color to transparent over one pixel, whose interpolated alpha is the
+ * coverage given by the distance to the edge.
+ */
+auto Canvas::expand() -> void
+{
+    auto vertex = [&](float x, float y, const SDL_Color& color) -> int
+    {
+        _vertices.push_back(VertexType{SDL_FPoint{x, y}, color, SDL_FPoint{0.0f, 0.0f}});
+        return int(_vertices.size()) - 1;
+    };
+
+    auto quad = [&](int a, int b, int c, int d) -> void
+    {
+        _indices.push_back(a);
+        _indices.push_back(b);
+        _indices.push_back(c);
+        _indices.push_back(a);
+        _indices.push_back(c);
+        _indices.push_back(d);
+    };
+
+    /*
+     * four rails along the capsule, the inner ones opaque and the outer ones
+     * transparent, the ends being pushed out by the radius
+     */
+    auto expand_line = [&](const Shape& shape, const SDL_Color& color, const SDL_Color& clear) -> void
+    {
+        const float dx     = (shape.x2 - shape.x1);
+        const float dy     = (shape.y2 - shape.y1);
+        const float length = ::sqrtf((dx * dx) + (dy * dy));
+        const float ux     = (length > 0.0f ? (dx / length) : 1.0f);
+        const float uy     = (length > 0.0f ? (dy / length) : 0.0f);
+        const float inner  = std::max(0.0f, (shape.radius - 0.5f));
+        const float outer  = (shape.radius + 0.5f);
+        const float ex     = (ux * shape.radius);
+        const float ey     = (uy * shape.radius);
+        const float x1     = (shape.x1 - ex);
+        const float y1     = (shape.y1 - ey);
+        const float x2     = (shape.x2 + ex);
+        const float y2     = (shape.y2 + ey);
+        const int   a0     = vertex((x1 - (uy * outer)), (y1 + (ux * outer)), clear);
+        const int   a1     = vertex((x1 - (uy * inner)), (y1 + (ux * inner)), color);
+        const int   a2     = vertex((x1 + (uy * inner)), (y1 - (ux * inner)), color);
+        const int   a3     = vertex((x1 + (uy * outer)), (y1 - (ux * outer)), clear);
+        const int   b0     = vertex((x2 - (uy * outer)), (y2 + (ux * outer)), clear);
+        const int   b1     = vertex((x2 - (uy * inner)), (y2 + (ux * inner)), color);
+        const int   b2     = vertex((x2 + (uy * inner)), (y2 - (ux * inner)), color);
+        const int   b3     = vertex((x2 + (uy * outer)), (y2 - (ux * outer)), clear);
+        quad(a0, b0, b1, a1);
+        quad(a1, b1, b2, a2);
+        quad(a2, b2, b3, a3);
+    };
+
+    /*
+     * a fan of triangles up to the inner rim, then a ring of quads up to the
+     * outer one, the level of detail dividing the number of segments
+     */
+    auto expand_disc = [&](const Shape& shape, const SDL_Color& color, const SDL_Color& clear) -> void
+    {
+        const int   segments = std::max(min_circle_segments, std::min(max_circle_segments, (int(shape.radius) / _circle_lod)));
+        const float angle    = (2.0f * float(M_PI) / float(segments));
+        const float cos_step = ::cosf(angle);
+        const float sin_step = ::sinf(angle);
+        const float inner    = std::max(0.0f, (shape.radius - 0.5f));
+        const float outer    = (shape.radius + 0.5f);
+        const int   center   = vertex(shape.x1, shape.y1, color);
+        float       dx       = 1.0f;
+        float       dy       = 0.0f;
+        for(int index = 0; index < segments; ++index) {
+            vertex((shape.x1 + (dx * inner)), (shape.y1 + (dy * inner)), color);
+            vertex((shape.x1 + (dx * outer)), (shape.y1 + (dy * outer)), clear);
+            const float rx = ((dx * cos_step) - (dy * sin_step));
+            const float ry = ((dx * sin_step) + (dy * cos_step));
+            dx = rx;
+            dy = ry;
+        }
+        for(int index = 0; index < segments; ++index) {
+            const int inner0 = (center + 1 + (2 * index));
+            const int inner1 = (center + 1 + (2 * ((index + 1) % segments)));
+            _indices.push_back(center);
+            _indices.push_back(inner0);
+            _indices.push_back(inner1);
+            quad(inner0, (inner0 + 1), (inner1 + 1), inner1);
+        }
+    };
+
+    for(auto& command : _commands) {
+        if((command.type == DrawType::LINES) || (command.type == DrawType::DISCS)) {
+            const SDL_Color color(unpack(command.color));
+            const SDL_Color clear = { color.r, color.g, color.b, 0 };
+            const int       first = int(_indices.size());
+            for(int index = command.first; index < (command.first + command.count); ++index) {
+                if(command.type == DrawType::LINES) {
+                    expand_line(_shapes[index], color, clear);
+                }
+                else {
+                    expand_disc(_shapes[index], color, clear);
                 }
-                m += ((8 * ++x) + 4);
             }
+            command.first = first;
+            command.count = (int(_indices.size()) - first);
+        }
+    }
+}
+
+/*
+ * merges the sorted runs of geometry into a single command per texture: the
+ * lines, the trails and the discs carry their colors in their vertices and
+ * share the same draw call, as do the sprites. The ranges of indices that are
+ * not adjacent are copied to the end of the indices, in the sorted order, so
+ * that the primitives keep their stacking within the merged range.
+ */
+auto Canvas::merge() -> void
+{
+    auto batch = [](int type) -> int
+    {
+        switch(type) {
+            case DrawType::LINES:
+            case DrawType::TRAILS:
+            case DrawType::DISCS:
+                return 0;
+            case DrawType::SPRITES:
+                return 1;
+            default:
+                break;
+        }
+        return -1;
+    };
+
+    auto append = [&](int first, int count) -> void
+    {
+        for(int index = first; index < (first + count); ++index) {
+            const int value = _indices[index];
+            _indices.push_back(value);
+        }
+    };
+
+    auto extend = [&](DrawCommand& merged, const DrawCommand& command) -> void
+    {
+        if((merged.first + merged.count) != command.first) {
+            if((merged.first + merged.count) != int(_indices.size())) {
+                const int first = int(_indices.size());
+                append(merged.first, merged.count);
+                merged.first = first;
+            }
+            append(command.first, command.count);
+        }
+        merged.count += command.count;
+    };
+
+    auto do_merge = [&]() -> void
+    {
+        auto output = _commands.begin();
+        auto input  = _commands.begin();
+        while(input != _commands.end()) {
+            DrawCommand merged(*input++);
+            if(batch(merged.type) >= 0) {
+                while((input != _commands.end()) && (batch(input->type) == batch(merged.type))) {
+                    extend(merged, *input++);
+                }
+            }
+            *output++ = merged;
+        }
+        _commands.erase(output, _commands.end());
+    };
+
+    return do_merge();
+}
+
+/*
+ * draws the frame once per clear into the streaming texture, at the
+ * internal resolution, and stretches it to the window in a single copy
+ */
+auto Canvas::rasterize(RendererType* renderer) -> void
+{
+    int output_w = 0;
+    int output_h = 0;
+
+    if((_pending == false) || (::SDL_GetRendererOutputSize(renderer, &output_w, &output_h) != 0)) {
+        return;
+    }
+    const int width  = std::max(1, int(float(output_w) * _resolution));
+    const int height = std::max(1, int(float(output_h) * _resolution));
+    if((bool(_framebuffer) == false) || (width != _framebuffer_w) || (height != _framebuffer_h)) {
+        _framebuffer.reset(::SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height));
+        _framebuffer_w = width;
+        _framebuffer_h = height;
+    }
+    if(bool(_framebuffer) == false) {
+        throw std::runtime_error("SDL_CreateTexture() has failed");
+    }
+    void* pixels = nullptr;
+    int   pitch  = 0;
+    if(::SDL_LockTexture(_framebuffer.get(), nullptr, &pixels, &pitch) != 0) {
+        return;
+    }
+    const RasterScene scene = {
+        _commands.data(),
+        int(_commands.size()),
+        _shapes.data(),
+        _vertices.data(),
+        _indices.data(),
+        _rects.data(),
+        _background,
+        _show_underlay,
+        _show_overlay,
+        (float(width) / float(output_w)),
+    };
+    _raster->render(scene, static_cast<uint32_t*>(pixels), pitch, width, height);
+    ::SDL_UnlockTexture(_framebuffer.get());
+    ::SDL_RenderCopy(renderer, _framebuffer.get(), nullptr, nullptr);
+    ++_draw_calls;
+    _pending = false;
+}
+
+auto Canvas::set_caption(const char* caption) -> void
+{
+    auto do_set_caption = [&](DrawableType* drawable) -> void
+    {
+        if(drawable != nullptr) {
+            ::SDL_SetWindowTitle(drawable, caption);
+        }
+    };
+
+    return do_set_caption(_drawable.get());
+}
+
+auto Canvas::set_resolution(float resolution) -> void
+{
+    _resolution = std::max(0.25f, std::min(1.0f, resolution));
+
+    if(_resolution >= 1.0f) {
+        _target.reset();
+    }
+}
+
+/*
+ * switches the vertical sync in place when the renderer supports it, or
+ * recreates the renderer along with its textures, the layers, the target
+ * and the sprites being drawn again lazily at the next frames
+ */
+auto Canvas::set_present_mode(int present_mode) -> void
+{
+    auto recreate = [&]() -> void
+    {
+        int width  = 0;
+        int height = 0;
+        ::SDL_GetWindowSize(_drawable.get(), &width, &height);
+        _framebuffer.reset();
+        _target.reset();
+        _background_layer.texture.reset();
+        _overlay_layer.texture.reset();
+        _heatmap.reset();
+        _underlay.reset();
+        _overlay.reset();
+        _sprites.reset();
+        _renderer.reset();
+        create(width, height);
+        invalidate();
+    };
+
+    const int vsync = (present_mode == PresentType::VSYNC ? 1 : 0);
+
+    if(::SDL_RenderSetVSync(_renderer.get(), vsync) != 0) {
+        recreate();
+    }
+    _present_time     = 0;
+    _present_deadline = 0;
+}
+
+/*
+ * uploads the pixels of the heatmap into its streaming texture, which the
+ * background layer is then drawn again with. The software rasterizer has
+ * no background layer, so that the heatmap is not shown with it.
+ */
+auto Canvas::update_heatmap(const uint32_t* pixels, int width, int height, float cell) -> void
+{
+    auto create_heatmap = [&](RendererType* renderer) -> void
+    {
+        _heatmap.reset(::SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height));
+        _heatmap_w = width;
+        _heatmap_h = height;
+        if(bool(_heatmap) == false) {
+            throw std::runtime_error("SDL_CreateTexture() has failed");
+        }
+        if(::SDL_SetTextureBlendMode(_heatmap.get(), SDL_BLENDMODE_BLEND) != 0) {
+            throw std::runtime_error("SDL_SetTextureBlendMode() has failed");
         }
+        ::SDL_SetTextureScaleMode(_heatmap.get(), SDL_ScaleModeLinear);
     };
 
-    return do_circle(_renderer.get());
+    auto do_update = [&](RendererType* renderer) -> void
+    {
+        if((bool(_heatmap) == false) || (width != _heatmap_w) || (height != _heatmap_h)) {
+            create_heatmap(renderer);
+        }
+        if(::SDL_UpdateTexture(_heatmap.get(), nullptr, pixels, (width * int(sizeof(uint32_t)))) != 0) {
+            return;
+        }
+        _heatmap_cell = cell;
+        _background_layer.stale = true;
+    };
+
+    if((bool(_renderer) == false) || (bool(_raster) != false)) {
+        return;
+    }
+    return do_update(_renderer.get());
+}
+
+auto Canvas::remove_heatmap() -> void
+{
+    if(bool(_heatmap) != false) {
+        _heatmap.reset();
+        _heatmap_w = 0;
+        _heatmap_h = 0;
+        _background_layer.stale = true;
+    }
+}
+
+/*
+ * the static layers are drawn again at the next frame, at the size of the
+ * window or of the internal resolution at that time
+ */
+auto Canvas::invalidate() -> void
+{
+    _background_layer.stale = true;
+    _overlay_layer.stale    = true;
+}
+
+auto Canvas::set_circle_lod(int circle_lod) -> void
+{
+    _circle_lod = std::max(1, circle_lod);
 }
 
 // ---------------------------------------------------------------------------
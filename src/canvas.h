@@ -28,6 +28,9 @@ using DrawableType                = SDL_Window;
 using RendererType                = SDL_Renderer;
 using SurfaceType                 = SDL_Surface;
 using TextureType                 = SDL_Texture;
+using RectType                    = SDL_Rect;
+using PointType                   = SDL_Point;
+using VertexType                  = SDL_Vertex;
 using EventType                   = SDL_Event;
 using CommonEventType             = SDL_CommonEvent;
 using DisplayEventType            = SDL_DisplayEvent;
@@ -168,10 +171,322 @@ struct Seg4i
     int y2 = 0;
 };
 
+// ---------------------------------------------------------------------------
+// DrawType
+// ---------------------------------------------------------------------------
+
+struct DrawType
+{
+    static constexpr int LINES   = 0;
+    static constexpr int TRAILS  = 1;
+    static constexpr int DISCS   = 2;
+    static constexpr int SPRITES = 3;
+    static constexpr int RECTS   = 4;
+};
+
+// ---------------------------------------------------------------------------
+// Shape
+//
+// anti-aliased primitive in sub-pixel coordinates: a capsule from (x1, y1)
+// to (x2, y2) of the given radius for a line, or a disc centered on (x1, y1)
+// for a circle. The coverage of a pixel is given by its signed distance to
+// the edge of the shape, so that the edge spans exactly one pixel.
+// ---------------------------------------------------------------------------
+
+struct Shape
+{
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+    float radius;
+};
+
+// ---------------------------------------------------------------------------
+// DrawCommand
+//
+// run of recorded primitives of the same type and color, the first and count
+// members being a range of the shapes, indices or rectangles of the canvas.
+// The order is the rank of the command at recording time.
+// ---------------------------------------------------------------------------
+
+struct DrawCommand
+{
+    int      type;
+    uint32_t color;
+    int      first;
+    int      count;
+    int      order;
+};
+
+// ---------------------------------------------------------------------------
+// Sprite
+//
+// disc of a given radius and color rasterized into a cell of the atlas, the
+// frame is the last one that drew it.
+// ---------------------------------------------------------------------------
+
+struct Sprite
+{
+    int      radius;
+    uint32_t color;
+    int      size;
+    RectType cell;
+    uint64_t frame;
+};
+
+// ---------------------------------------------------------------------------
+// SpriteShelf
+//
+// row of the atlas holding count cells of the given size.
+// ---------------------------------------------------------------------------
+
+struct SpriteShelf
+{
+    int y;
+    int size;
+    int count;
+};
+
+// ---------------------------------------------------------------------------
+// SpriteCache
+//
+// atlas of pre-rasterized discs keyed by radius and color. The atlas is cut
+// into shelves, each shelf holding square cells of a single power-of-two
+// size. When no cell of the required size is left, the least recently used
+// sprite of that size is evicted, unless it was drawn during the current
+// frame, in which case the lookup fails and the caller has to fall back.
+// The canvas then records a shape instead, as it does for the discs too
+// large for the cells.
+// ---------------------------------------------------------------------------
+
+class SpriteCache
+{
+public: // public interface
+    SpriteCache();
+
+    SpriteCache(const SpriteCache&) = delete;
+
+    SpriteCache& operator=(const SpriteCache&) = delete;
+
+    virtual ~SpriteCache() = default;
+
+    auto create(RendererType* renderer) -> void;
+
+    auto reset() -> void;
+
+    auto find(int radius, uint32_t color, uint64_t frame) -> const Sprite*;
+
+public: // public accessors
+    auto texture() const -> TextureType*
+    {
+        return _atlas.get();
+    }
+
+    auto size() const -> int
+    {
+        return int(_sprites.size());
+    }
+
+    auto misses() const -> uint64_t
+    {
+        return _misses;
+    }
+
+    auto evictions() const -> uint64_t
+    {
+        return _evictions;
+    }
+
+private: // private interface
+    auto allocate(int size, uint64_t frame) -> Sprite*;
+
+    auto rasterize(const Sprite& sprite) -> void;
+
+private: // private data
+    std::unique_ptr<TextureType> _atlas;
+    std::vector<Sprite>          _sprites;
+    std::vector<SpriteShelf>     _shelves;
+    std::vector<uint8_t>         _pixels;
+    int                          _top;
+    int                          _last;
+    uint64_t                     _misses;
+    uint64_t                     _evictions;
+};
+
+// ---------------------------------------------------------------------------
+// StaticLayer
+//
+// render target holding an image pre-scaled to the size it is drawn at, the
+// layer being stale when it has to be drawn again. The background layer also
+// holds the heatmap, when there is one, drawn over the underlay.
+// ---------------------------------------------------------------------------
+
+struct StaticLayer
+{
+    std::unique_ptr<TextureType> texture;
+    int                          width  = 0;
+    int                          height = 0;
+    bool                         stale  = true;
+};
+
+// ---------------------------------------------------------------------------
+// DirtyRegion
+//
+// grid of cells covering the window, marking the bounds of the primitives of
+// the current frame. The dirty region of a frame is the union of the cells
+// marked by the previous frame and by the current one, merged into as few
+// rectangles as possible. When it covers too much of the window, or after an
+// invalidation, the whole frame has to be redrawn instead. The canvas keeps
+// the frame in a render target from one frame to the next for that purpose,
+// except with the software rasterizer, which draws every frame in whole.
+// ---------------------------------------------------------------------------
+
+class DirtyRegion
+{
+public: // public interface
+    DirtyRegion();
+
+    DirtyRegion(const DirtyRegion&) = delete;
+
+    DirtyRegion& operator=(const DirtyRegion&) = delete;
+
+    virtual ~DirtyRegion() = default;
+
+    auto resize(int width, int height) -> void;
+
+    auto invalidate() -> void;
+
+    auto add(float x0, float y0, float x1, float y1) -> void;
+
+    auto update() -> bool;
+
+public: // public accessors
+    auto rects() const -> const std::vector<RectType>&
+    {
+        return _rects;
+    }
+
+    auto width() const -> int
+    {
+        return _width;
+    }
+
+    auto height() const -> int
+    {
+        return _height;
+    }
+
+    auto area() const -> float
+    {
+        return _area;
+    }
+
+private: // private data
+    int                   _width;
+    int                   _height;
+    int                   _cols;
+    int                   _rows;
+    std::vector<uint8_t>  _cells;
+    std::vector<RectType> _rects;
+    bool                  _invalid;
+    float                 _area;
+};
+
+// ---------------------------------------------------------------------------
+// Camera
+//
+// view of the world in the window, centered on the center of the window
+// shifted by the pan and scaled by the zoom around it, so that the world and
+// the window coordinates are the same with the default camera. The pan is
+// in world units, so that the view follows the objects when the window is
+// resized. The canvas transforms the primitives when they are recorded,
+// culling those out of the view and recording the discs smaller than a
+// pixel as points.
+// ---------------------------------------------------------------------------
+
+class Camera
+{
+public: // public interface
+    Camera();
+
+    Camera(const Camera&) = delete;
+
+    Camera& operator=(const Camera&) = delete;
+
+    virtual ~Camera() = default;
+
+    auto resize(int width, int height) -> void;
+
+    auto reset() -> void;
+
+    auto pan(float dx, float dy) -> void;
+
+    auto zoom_at(float x, float y, float factor) -> void;
+
+public: // public accessors
+    auto width() const -> float
+    {
+        return _width;
+    }
+
+    auto height() const -> float
+    {
+        return _height;
+    }
+
+    auto zoom() const -> float
+    {
+        return _zoom;
+    }
+
+    auto to_screen_x(float x) const -> float
+    {
+        return ((x - _center_x - _pan_x) * _zoom) + _center_x;
+    }
+
+    auto to_screen_y(float y) const -> float
+    {
+        return ((y - _center_y - _pan_y) * _zoom) + _center_y;
+    }
+
+    auto to_world_x(float x) const -> float
+    {
+        return ((x - _center_x) / _zoom) + _center_x + _pan_x;
+    }
+
+    auto to_world_y(float y) const -> float
+    {
+        return ((y - _center_y) / _zoom) + _center_y + _pan_y;
+    }
+
+    auto visible(float x0, float y0, float x1, float y1) const -> bool
+    {
+        return (x1 >= 0.0f) && (y1 >= 0.0f) && (x0 <= _width) && (y0 <= _height);
+    }
+
+private: // private data
+    float _width;
+    float _height;
+    float _center_x;
+    float _center_y;
+    float _pan_x;
+    float _pan_y;
+    float _zoom;
+};
+
 // ---------------------------------------------------------------------------
 // Canvas
+//
+// the primitives are not drawn when requested but recorded into vertex and
+// command buffers, which are sorted by type and color and flushed in as few
+// renderer calls as possible before the frame is presented. Whatever the
+// recording order, the lines are drawn below the trails, the trails below the
+// discs, the discs below the sprites and the sprites below the rectangles.
 // ---------------------------------------------------------------------------
 
+class Raster;
+
 class Canvas
 {
 public: // public interface
@@ -181,26 +496,94 @@ public: // public interface
 
     Canvas& operator=(const Canvas&) = delete;
 
-    virtual ~Canvas() = default;
+    virtual ~Canvas();
 
     auto clear() -> void;
 
-    auto present() -> void;
+    auto flush() -> void;
+
+    auto reserve(int lines, int circles, int rects, int trails) -> void;
+
+    auto present() -> bool;
 
     auto color(const Col4i& color) -> void;
 
-    auto line(int x1, int y1, int x2, int y2) -> void;
+    auto line(float x1, float y1, float x2, float y2) -> void;
+
+    auto circle(float xc, float yc, float r) -> void;
+
+    auto sprite(float xc, float yc, float r) -> void;
+
+    auto point(float x, float y) -> void;
+
+    auto trail(const float* xs, const float* ys, int size, int first, int count, float r) -> void;
+
+    auto fill_rects(const RectType* rects, int count) -> void;
+
+    auto visible(float x0, float y0, float x1, float y1) const -> bool;
+
+    auto subpixel(float radius) const -> bool;
+
+    auto set_caption(const char* caption) -> void;
+
+    auto set_resolution(float resolution) -> void;
+
+    auto set_circle_lod(int circle_lod) -> void;
 
-    auto circle(int xc, int yc, int r) -> void;
+    auto invalidate() -> void;
+
+    auto set_present_mode(int present_mode) -> void;
+
+    auto update_heatmap(const uint32_t* pixels, int width, int height, float cell) -> void;
+
+    auto remove_heatmap() -> void;
+
+    auto draw_calls() const -> uint32_t
+    {
+        return _frame_draw_calls;
+    }
+
+    auto sprites() const -> const SpriteCache&
+    {
+        return _sprites;
+    }
+
+    auto camera() -> Camera&
+    {
+        return _camera;
+    }
+
+    auto dirty() const -> const DirtyRegion&
+    {
+        return _dirty;
+    }
+
+    auto presented() const -> uint32_t
+    {
+        return _presented;
+    }
+
+    auto dropped() const -> uint32_t
+    {
+        return _dropped;
+    }
+
+    auto reset_presents() -> void
+    {
+        _presented = 0;
+        _dropped   = 0;
+    }
 
     auto toggle_underlay() -> void
     {
         _show_underlay = !_show_underlay;
+        _background_layer.stale = true;
     }
 
     auto toggle_overlay() -> void
     {
         _show_overlay = !_show_overlay;
+        _overlay_layer.stale = true;
     }
 
     operator DrawableType*() const
@@ -216,12 +599,64 @@ public: // public interface
 protected: // protected interface
     auto create(const int width, const int height) -> void;
 
+    auto record(int type, int first, int count) -> void;
+
+    auto add_disc(float xc, float yc, float r) -> void;
+
+    auto add_point(float x, float y) -> void;
+
+    auto restore(RendererType* renderer) -> void;
+
+    auto render_layer(RendererType* renderer, StaticLayer& layer, TextureType* source, const SDL_Color& color, int width, int height, SDL_BlendMode mode) -> void;
+
+    auto expand() -> void;
+
+    auto merge() -> void;
+
+    auto rasterize(RendererType* renderer) -> void;
+
 protected: // protected data
     std::string                   _title;
     std::unique_ptr<DrawableType> _drawable;
     std::unique_ptr<RendererType> _renderer;
     std::unique_ptr<TextureType>  _underlay;
     std::unique_ptr<TextureType>  _overlay;
+    std::unique_ptr<TextureType>  _target;
+    int                           _target_w;
+    int                           _target_h;
+    StaticLayer                   _background_layer;
+    StaticLayer                   _overlay_layer;
+    std::unique_ptr<TextureType>  _heatmap;
+    int                           _heatmap_w;
+    int                           _heatmap_h;
+    float                         _heatmap_cell;
+    RectType                      _heatmap_rect;
+    std::unique_ptr<Raster>       _raster;
+    std::unique_ptr<TextureType>  _framebuffer;
+    int                           _framebuffer_w;
+    int                           _framebuffer_h;
+    uint32_t                      _background;
+    bool                          _pending;
+    float                         _resolution;
+    int                           _circle_lod;
+    Col4i                         _color;
+    Camera                        _camera;
+    std::vector<Shape>            _shapes;
+    std::vector<VertexType>       _vertices;
+    std::vector<int>              _indices;
+    std::vector<RectType>         _rects;
+    std::vector<DrawCommand>      _commands;
+    uint32_t                      _draw_calls;
+    uint32_t                      _frame_draw_calls;
+    SpriteCache                   _sprites;
+    DirtyRegion                   _dirty;
+    uint32_t                      _restored;
+    int                           _refresh_rate;
+    uint64_t                      _present_time;
+    uint64_t                      _present_deadline;
+    uint32_t                      _presented;
+    uint32_t                      _dropped;
+    uint64_t                      _frame;
     bool                          _show_underlay;
     bool                          _show_overlay;
 };
@@ -0,0 +1,167 @@
+/*
+ * concurrent.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Concurrent_h__
+#define __Concurrent_h__
+
+// ---------------------------------------------------------------------------
+// SpscQueue
+//
+// bounded lock-free queue for exactly one producer thread and one consumer
+// thread. The items live in a fixed ring, so neither side ever allocates.
+// ---------------------------------------------------------------------------
+
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+public: // public interface
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "items must be trivially copyable");
+
+    SpscQueue()
+        : _items()
+        , _head(0)
+        , _head_padding()
+        , _tail(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    virtual ~SpscQueue() = default;
+
+    auto push(const T& item) -> bool
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t head = _head.load(std::memory_order_acquire);
+
+        if((tail - head) >= Capacity) {
+            return false;
+        }
+        _items[tail & (Capacity - 1)] = item;
+        _tail.store((tail + 1), std::memory_order_release);
+        return true;
+    }
+
+    auto pop(T& item) -> bool
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        const size_t tail = _tail.load(std::memory_order_acquire);
+
+        if(head == tail) {
+            return false;
+        }
+        item = _items[head & (Capacity - 1)];
+        _head.store((head + 1), std::memory_order_release);
+        return true;
+    }
+
+private: // private data
+    static constexpr size_t cache_line = 64;
+
+    T                   _items[Capacity];
+    std::atomic<size_t> _head;
+    char                _head_padding[cache_line - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> _tail;
+};
+
+// ---------------------------------------------------------------------------
+// TripleBuffer
+//
+// lock-free single-writer/single-reader exchange of the latest value. The
+// writer fills back() then publish() swaps it with the middle slot; the
+// reader calls acquire() to swap the middle slot with front() when a newer
+// value has been published. Neither side ever waits for the other one.
+// ---------------------------------------------------------------------------
+
+template <typename T>
+class TripleBuffer
+{
+public: // public interface
+    TripleBuffer()
+        : _slots()
+        , _back(0)
+        , _middle(1)
+        , _front(2)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    virtual ~TripleBuffer() = default;
+
+    template <typename Function>
+    auto for_each(Function&& function) -> void
+    {
+        for(auto& slot : _slots) {
+            function(slot);
+        }
+    }
+
+    auto back() -> T&
+    {
+        return _slots[_back];
+    }
+
+    auto front() -> T&
+    {
+        return _slots[_front];
+    }
+
+    /*
+     * returns false when the previously published value was never acquired,
+     * in which case back() is that stale value rather than an acquired one
+     */
+    auto publish() -> bool
+    {
+        const uint8_t middle = _middle.exchange((_back | fresh_bit), std::memory_order_acq_rel);
+
+        _back = (middle & index_mask);
+
+        return (middle & fresh_bit) == 0;
+    }
+
+    auto acquire() -> bool
+    {
+        if((_middle.load(std::memory_order_relaxed) & fresh_bit) == 0) {
+            return false;
+        }
+        const uint8_t middle = _middle.exchange(_front, std::memory_order_acq_rel);
+
+        _front = (middle & index_mask);
+
+        return true;
+    }
+
+private: // private data
+    static constexpr uint8_t fresh_bit  = 0x04;
+    static constexpr uint8_t index_mask = 0x03;
+
+    T                    _slots[3];
+    uint8_t              _back;
+    std::atomic<uint8_t> _middle;
+    uint8_t              _front;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Concurrent_h__ */
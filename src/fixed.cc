@@ -0,0 +1,141 @@
+/*
+ * fixed.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "fixed.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::SineTable
+//
+// quarter-wave sine table, built once with an integer Taylor series so that
+// it does not depend on the libm of the target. The linear interpolation
+// between two entries has a maximum error of about 3e-7.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class SineTable
+{
+public: // public interface
+    static constexpr int quarter_bits = 10;
+    static constexpr int quarter_size = (1 << quarter_bits);
+
+    SineTable()
+        : _table()
+    {
+        for(int index = 0; index <= quarter_size; ++index) {
+            _table[index] = taylor(Fixed::from_raw((Fixed::raw_half_pi * index) / quarter_size)).raw;
+        }
+    }
+
+    auto sin(const Fixed& angle) const -> Fixed
+    {
+        const uint32_t phase    = uint32_t(uint64_t(fixed_mul(angle.raw, Fixed::raw_inv_2pi)));
+        const uint32_t quadrant = (phase >> 30);
+        const uint32_t position = (phase & 0x3fffffffu);
+
+        switch(quadrant) {
+            case 0:
+                return Fixed::from_raw(+lookup(position));
+            case 1:
+                return Fixed::from_raw(+lookup(0x40000000u - position));
+            case 2:
+                return Fixed::from_raw(-lookup(position));
+            default:
+                break;
+        }
+        return Fixed::from_raw(-lookup(0x40000000u - position));
+    }
+
+private: // private interface
+    static auto taylor(const Fixed& angle) -> Fixed
+    {
+        const Fixed square(angle * angle);
+        Fixed       term(angle);
+        Fixed       result(angle);
+
+        for(int order = 3; term.raw != 0; order += 2) {
+            term   = -((term * square) / (order * (order - 1)));
+            result += term;
+        }
+        return result;
+    }
+
+    auto lookup(uint32_t position) const -> int64_t
+    {
+        constexpr int fraction_bits = (30 - quarter_bits);
+        constexpr int fraction_mask = ((1 << fraction_bits) - 1);
+
+        const uint32_t index = (position >> fraction_bits);
+        if(index >= quarter_size) {
+            return _table[quarter_size];
+        }
+        const int64_t lower    = _table[index + 0];
+        const int64_t upper    = _table[index + 1];
+        const int64_t fraction = (position & fraction_mask);
+
+        return lower + (((upper - lower) * fraction) >> fraction_bits);
+    }
+
+private: // private data
+    int64_t _table[quarter_size + 1];
+};
+
+auto sine_table() -> const SineTable&
+{
+    static const SineTable table;
+
+    return table;
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Fixed functions
+// ---------------------------------------------------------------------------
+
+auto sin(const Fixed& angle) -> Fixed
+{
+    return sine_table().sin(angle);
+}
+
+auto cos(const Fixed& angle) -> Fixed
+{
+    return sine_table().sin(angle + Fixed::from_raw(Fixed::raw_half_pi));
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
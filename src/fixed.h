@@ -0,0 +1,495 @@
+/*
+ * fixed.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Fixed_h__
+#define __Fixed_h__
+
+#include "geometry.h"
+
+// ---------------------------------------------------------------------------
+// Fixed
+//
+// Q32.32 signed fixed-point number. All the arithmetic is done on integers
+// so that the results are bit-exact on every compiler and every target.
+//
+// The objects keep their state in floats: the fixed-point steps convert it
+// to Fixed on entry and back to float on exit, so that each step rounds its
+// results to float. Both conversions are exact or correctly rounded, hence a
+// simulation is reproducible bit for bit from identical float inputs, but it
+// does not carry the precision of Q32.32 from one step to the next.
+// ---------------------------------------------------------------------------
+
+struct Fixed
+{
+    static constexpr int     fraction_bits = 32;
+    static constexpr int64_t raw_one       = (int64_t(1) << fraction_bits);
+    static constexpr int64_t raw_two_pi    = int64_t(26986075409);
+    static constexpr int64_t raw_half_pi   = int64_t(6746518852);
+    static constexpr int64_t raw_inv_2pi   = int64_t(683565276);
+
+    Fixed()
+        : raw(0)
+    {
+    }
+
+    explicit Fixed(int value)
+        : raw(int64_t(value) * raw_one)
+    {
+    }
+
+    explicit Fixed(float value)
+        : raw(from_float(value))
+    {
+    }
+
+    static auto from_raw(int64_t raw) -> Fixed
+    {
+        Fixed result;
+        result.raw = raw;
+        return result;
+    }
+
+    static auto from_float(float value) -> int64_t
+    {
+        constexpr double limit = 2147483647.0;
+
+        double scaled = double(value);
+        if(scaled != scaled) {
+            return 0;
+        }
+        if(scaled > +limit) {
+            scaled = +limit;
+        }
+        if(scaled < -limit) {
+            scaled = -limit;
+        }
+        return int64_t(scaled * double(raw_one));
+    }
+
+    auto to_float() const -> float
+    {
+        return float(double(raw) / double(raw_one));
+    }
+
+    int64_t raw;
+};
+
+// ---------------------------------------------------------------------------
+// Fixed primitives
+// ---------------------------------------------------------------------------
+
+inline auto fixed_mul(int64_t lhs, int64_t rhs) -> int64_t
+{
+#ifdef __SIZEOF_INT128__
+    return int64_t((__int128(lhs) * __int128(rhs)) >> Fixed::fraction_bits);
+#else
+    const uint64_t ua = uint64_t(lhs);
+    const uint64_t ub = uint64_t(rhs);
+    const uint64_t al = (ua & 0xffffffffu);
+    const uint64_t ah = (ua >> 32);
+    const uint64_t bl = (ub & 0xffffffffu);
+    const uint64_t bh = (ub >> 32);
+    const uint64_t ll = (al * bl);
+    const uint64_t lh = (al * bh);
+    const uint64_t hl = (ah * bl);
+    const uint64_t hh = (ah * bh);
+    const uint64_t md = ((ll >> 32) + (lh & 0xffffffffu) + (hl & 0xffffffffu));
+    const uint64_t lo = ((md << 32) | (ll & 0xffffffffu));
+    uint64_t       hi = (hh + (lh >> 32) + (hl >> 32) + (md >> 32));
+    if(lhs < 0) {
+        hi -= ub;
+    }
+    if(rhs < 0) {
+        hi -= ua;
+    }
+    return int64_t((hi << 32) | (lo >> 32));
+#endif
+}
+
+/*
+ * a zero divisor saturates the quotient by the sign of the dividend rather
+ * than trapping, zero divided by zero being zero
+ */
+inline auto fixed_div(int64_t lhs, int64_t rhs) -> int64_t
+{
+    if(rhs == 0) {
+        return (lhs > 0 ? std::numeric_limits<int64_t>::max() : lhs < 0 ? std::numeric_limits<int64_t>::min() : 0);
+    }
+#ifdef __SIZEOF_INT128__
+    return int64_t((__int128(lhs) * __int128(Fixed::raw_one)) / __int128(rhs));
+#else
+    const bool     negative = ((lhs < 0) != (rhs < 0));
+    const uint64_t divisor  = (rhs < 0 ? (0 - uint64_t(rhs)) : uint64_t(rhs));
+    const uint64_t dividend = (lhs < 0 ? (0 - uint64_t(lhs)) : uint64_t(lhs));
+    const uint64_t num_hi   = (dividend >> 32);
+    const uint64_t num_lo   = (dividend << 32);
+    uint64_t       quotient = 0;
+    uint64_t       rest     = 0;
+    for(int bit = 127; bit >= 0; --bit) {
+        const uint64_t carry = (rest >> 63);
+        const uint64_t next  = (bit >= 64 ? (num_hi >> (bit - 64)) : (num_lo >> bit)) & 1u;
+        rest = ((rest << 1) | next);
+        quotient <<= 1;
+        if((carry != 0) || (rest >= divisor)) {
+            rest -= divisor;
+            quotient |= 1u;
+        }
+    }
+    return (negative != false ? int64_t(0 - quotient) : int64_t(quotient));
+#endif
+}
+
+inline auto isqrt(uint64_t value) -> uint64_t
+{
+    uint64_t result = 0;
+    uint64_t bit    = (uint64_t(1) << 62);
+
+    while(bit > value) {
+        bit >>= 2;
+    }
+    while(bit != 0) {
+        if(value >= (result + bit)) {
+            value  -= (result + bit);
+            result  = ((result >> 1) + bit);
+        }
+        else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Fixed operators
+// ---------------------------------------------------------------------------
+
+inline auto operator+(const Fixed& value) -> Fixed
+{
+    return Fixed::from_raw(+value.raw);
+}
+
+inline auto operator-(const Fixed& value) -> Fixed
+{
+    return Fixed::from_raw(-value.raw);
+}
+
+inline auto operator+(const Fixed& lhs, const Fixed& rhs) -> Fixed
+{
+    return Fixed::from_raw(lhs.raw + rhs.raw);
+}
+
+inline auto operator-(const Fixed& lhs, const Fixed& rhs) -> Fixed
+{
+    return Fixed::from_raw(lhs.raw - rhs.raw);
+}
+
+inline auto operator*(const Fixed& lhs, const Fixed& rhs) -> Fixed
+{
+    return Fixed::from_raw(fixed_mul(lhs.raw, rhs.raw));
+}
+
+inline auto operator/(const Fixed& lhs, const Fixed& rhs) -> Fixed
+{
+    return Fixed::from_raw(fixed_div(lhs.raw, rhs.raw));
+}
+
+inline auto operator*(const Fixed& lhs, const int value) -> Fixed
+{
+    return Fixed::from_raw(lhs.raw * value);
+}
+
+inline auto operator/(const Fixed& lhs, const int value) -> Fixed
+{
+    return Fixed::from_raw(lhs.raw / value);
+}
+
+inline auto operator+=(Fixed& lhs, const Fixed& rhs) -> Fixed&
+{
+    lhs.raw += rhs.raw;
+    return lhs;
+}
+
+inline auto operator-=(Fixed& lhs, const Fixed& rhs) -> Fixed&
+{
+    lhs.raw -= rhs.raw;
+    return lhs;
+}
+
+inline auto operator*=(Fixed& lhs, const Fixed& rhs) -> Fixed&
+{
+    lhs.raw = fixed_mul(lhs.raw, rhs.raw);
+    return lhs;
+}
+
+inline auto operator/=(Fixed& lhs, const Fixed& rhs) -> Fixed&
+{
+    lhs.raw = fixed_div(lhs.raw, rhs.raw);
+    return lhs;
+}
+
+inline auto operator==(const Fixed& lhs, const Fixed& rhs) -> bool
+{
+    return lhs.raw == rhs.raw;
+}
+
+inline auto operator!=(const Fixed& lhs, const Fixed& rhs) -> bool
+{
+    return lhs.raw != rhs.raw;
+}
+
+inline auto operator<(const Fixed& lhs, const Fixed& rhs) -> bool
+{
+    return lhs.raw < rhs.raw;
+}
+
+inline auto operator<=(const Fixed& lhs, const Fixed& rhs) -> bool
+{
+    return lhs.raw <= rhs.raw;
+}
+
+inline auto operator>(const Fixed& lhs, const Fixed& rhs) -> bool
+{
+    return lhs.raw > rhs.raw;
+}
+
+inline auto operator>=(const Fixed& lhs, const Fixed& rhs) -> bool
+{
+    return lhs.raw >= rhs.raw;
+}
+
+// ---------------------------------------------------------------------------
+// Fixed functions
+// ---------------------------------------------------------------------------
+
+inline auto sqrt(const Fixed& value) -> Fixed
+{
+    if(value.raw <= 0) {
+        return Fixed();
+    }
+    const uint64_t raw = uint64_t(value.raw);
+    if(raw < (uint64_t(1) << 32)) {
+        return Fixed::from_raw(int64_t(isqrt(raw << 32)));
+    }
+    const int shift = (__builtin_clzll(raw) & ~1);
+
+    return Fixed::from_raw(int64_t(isqrt(raw << shift) << ((32 - shift) / 2)));
+}
+
+auto sin(const Fixed& angle) -> Fixed;
+
+auto cos(const Fixed& angle) -> Fixed;
+
+// ---------------------------------------------------------------------------
+// Pos2x
+// ---------------------------------------------------------------------------
+
+struct Pos2x
+{
+    Pos2x()
+        : x()
+        , y()
+    {
+    }
+
+    Pos2x(const Fixed& vx, const Fixed& vy)
+        : x(vx)
+        , y(vy)
+    {
+    }
+
+    explicit Pos2x(const Pos2f& position)
+        : x(position.x)
+        , y(position.y)
+    {
+    }
+
+    auto to_float() const -> Pos2f
+    {
+        return Pos2f(x.to_float(), y.to_float());
+    }
+
+    Fixed x;
+    Fixed y;
+};
+
+// ---------------------------------------------------------------------------
+// Vec2x
+// ---------------------------------------------------------------------------
+
+struct Vec2x
+{
+    Vec2x()
+        : x()
+        , y()
+    {
+    }
+
+    Vec2x(const Fixed& xy)
+        : x(xy)
+        , y(xy)
+    {
+    }
+
+    Vec2x(const Fixed& vx, const Fixed& vy)
+        : x(vx)
+        , y(vy)
+    {
+    }
+
+    explicit Vec2x(const Vec2f& vector)
+        : x(vector.x)
+        , y(vector.y)
+    {
+    }
+
+    auto to_float() const -> Vec2f
+    {
+        return Vec2f(x.to_float(), y.to_float());
+    }
+
+    Fixed x;
+    Fixed y;
+};
+
+// ---------------------------------------------------------------------------
+// Pos2x operators
+// ---------------------------------------------------------------------------
+
+inline auto operator+(const Pos2x& lhs, const Vec2x& rhs) -> Pos2x
+{
+    return Pos2x((lhs.x + rhs.x), (lhs.y + rhs.y));
+}
+
+inline auto operator-(const Pos2x& lhs, const Vec2x& rhs) -> Pos2x
+{
+    return Pos2x((lhs.x - rhs.x), (lhs.y - rhs.y));
+}
+
+inline auto operator+=(Pos2x& lhs, const Vec2x& rhs) -> Pos2x&
+{
+    lhs.x += rhs.x;
+    lhs.y += rhs.y;
+    return lhs;
+}
+
+inline auto operator-=(Pos2x& lhs, const Vec2x& rhs) -> Pos2x&
+{
+    lhs.x -= rhs.x;
+    lhs.y -= rhs.y;
+    return lhs;
+}
+
+inline auto operator-(const Pos2x& lhs, const Pos2x& rhs) -> Vec2x
+{
+    return Vec2x((lhs.x - rhs.x), (lhs.y - rhs.y));
+}
+
+// ---------------------------------------------------------------------------
+// Vec2x operators
+// ---------------------------------------------------------------------------
+
+inline auto operator+(const Vec2x& lhs, const Vec2x& rhs) -> Vec2x
+{
+    return Vec2x((lhs.x + rhs.x), (lhs.y + rhs.y));
+}
+
+inline auto operator-(const Vec2x& lhs, const Vec2x& rhs) -> Vec2x
+{
+    return Vec2x((lhs.x - rhs.x), (lhs.y - rhs.y));
+}
+
+inline auto operator*(const Vec2x& lhs, const Vec2x& rhs) -> Vec2x
+{
+    return Vec2x((lhs.x * rhs.x), (lhs.y * rhs.y));
+}
+
+inline auto operator*(const Vec2x& lhs, const Fixed& value) -> Vec2x
+{
+    return Vec2x((lhs.x * value), (lhs.y * value));
+}
+
+inline auto operator/(const Vec2x& lhs, const Fixed& value) -> Vec2x
+{
+    return Vec2x((lhs.x / value), (lhs.y / value));
+}
+
+inline auto operator+=(Vec2x& lhs, const Vec2x& rhs) -> Vec2x&
+{
+    lhs.x += rhs.x;
+    lhs.y += rhs.y;
+    return lhs;
+}
+
+inline auto operator-=(Vec2x& lhs, const Vec2x& rhs) -> Vec2x&
+{
+    lhs.x -= rhs.x;
+    lhs.y -= rhs.y;
+    return lhs;
+}
+
+inline auto operator*=(Vec2x& lhs, const Vec2x& rhs) -> Vec2x&
+{
+    lhs.x *= rhs.x;
+    lhs.y *= rhs.y;
+    return lhs;
+}
+
+inline auto operator*=(Vec2x& lhs, const Fixed& value) -> Vec2x&
+{
+    lhs.x *= value;
+    lhs.y *= value;
+    return lhs;
+}
+
+inline auto dot(const Vec2x& lhs, const Vec2x& rhs) -> Fixed
+{
+    return (lhs.x * rhs.x) + (lhs.y * rhs.y);
+}
+
+inline auto length(const Vec2x& vector) -> Fixed
+{
+    return sqrt(dot(vector, vector));
+}
+
+inline auto length_normal(const Vec2x& vector, Vec2x& normal) -> Fixed
+{
+    const Fixed length = sqrt(dot(vector, vector));
+
+    if(length.raw == 0) {
+        normal = Vec2x();
+    }
+    else {
+        normal = Vec2x((vector.x / length), (vector.y / length));
+    }
+    return length;
+}
+
+inline auto perpendicular(const Vec2x& vector) -> Vec2x
+{
+    return Vec2x(-vector.y, +vector.x);
+}
+
+inline auto reflect(const Vec2x& vector, const Vec2x& normal) -> Vec2x
+{
+    return Vec2x(vector - (normal * (dot(vector, normal) * 2)));
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Fixed_h__ */
@@ -84,7 +84,7 @@ inline auto operator+(const Pos2f& lhs, const Vec2f& rhs) -> Pos2f
 
 inline auto operator-(const Pos2f& lhs, const Vec2f& rhs) -> Pos2f
 {
-    return Pos2f((lhs.x + rhs.x), (lhs.y + rhs.y));
+    return Pos2f((lhs.x - rhs.x), (lhs.y - rhs.y));
 }
 
 inline auto operator*(const Pos2f& lhs, const Vec2f& rhs) -> Pos2f
@@ -236,6 +236,671 @@ inline auto reflect(const Vec2f& vector, const Vec2f& normal) -> Vec2f
     return Vec2f(vector - (normal * (2.0f * dot(vector, normal))));
 }
 
+inline auto length_squared(const Vec2f& vector) -> float
+{
+    return float((vector.x * vector.x) + (vector.y * vector.y));
+}
+
+inline auto length_normal(const Vec2f& vector, Vec2f& normal) -> float
+{
+    const float length = ::hypotf(vector.x, vector.y);
+
+    if(length == 0.0f) {
+        normal = Vec2f();
+    }
+    else {
+        normal = Vec2f((vector.x / length), (vector.y / length));
+    }
+    return length;
+}
+
+// ---------------------------------------------------------------------------
+// Vec2f fast-math functions
+//
+// rsqrt() uses the bit-level initial guess refined by two Newton-Raphson
+// steps, the maximum relative error is below 5e-6 over the whole range of
+// normal floats (i.e. less than 0.01 pixel for a length of 2000 pixels).
+// The fast_xxx() functions inherit that bound plus one rounding, and do
+// not guard against overflow or underflow like ::hypotf() does.
+// ---------------------------------------------------------------------------
+
+inline auto rsqrt(const float value) -> float
+{
+    uint32_t bits;
+    float    guess;
+
+    ::memcpy(&bits, &value, sizeof(bits));
+    bits = 0x5f375a86u - (bits >> 1);
+    ::memcpy(&guess, &bits, sizeof(guess));
+    guess *= (1.5f - (0.5f * value * guess * guess));
+    guess *= (1.5f - (0.5f * value * guess * guess));
+    return guess;
+}
+
+inline auto fast_length(const Vec2f& vector) -> float
+{
+    const float length2 = length_squared(vector);
+
+    if(length2 == 0.0f) {
+        return 0.0f;
+    }
+    return length2 * rsqrt(length2);
+}
+
+inline auto fast_normalize(const Vec2f& vector) -> Vec2f
+{
+    const float length2 = length_squared(vector);
+
+    if(length2 == 0.0f) {
+        return Vec2f();
+    }
+    return vector * rsqrt(length2);
+}
+
+inline auto fast_length_normal(const Vec2f& vector, Vec2f& normal) -> float
+{
+    const float length2 = length_squared(vector);
+
+    if(length2 == 0.0f) {
+        normal = Vec2f();
+        return 0.0f;
+    }
+    const float inverse = rsqrt(length2);
+    normal = vector * inverse;
+    return length2 * inverse;
+}
+
+// ---------------------------------------------------------------------------
+// packed lane types
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef float   Floatx4 __attribute__((vector_size(4 * sizeof(float))));
+typedef int32_t Maskx4  __attribute__((vector_size(4 * sizeof(int32_t))));
+typedef float   Floatx8 __attribute__((vector_size(8 * sizeof(float))));
+typedef int32_t Maskx8  __attribute__((vector_size(8 * sizeof(int32_t))));
+
+// ---------------------------------------------------------------------------
+// LaneOps
+// ---------------------------------------------------------------------------
+
+template <typename F, typename M, int N>
+struct LaneOps
+{
+    using Float = F;
+    using Mask  = M;
+
+    static constexpr int count = N;
+
+    static auto select(const Mask& mask, const Float& lhs, const Float& rhs) -> Float
+    {
+        return Float((mask & Mask(lhs)) | (~mask & Mask(rhs)));
+    }
+
+    static auto sqrt(const Float& value) -> Float
+    {
+        Float result;
+        for(int lane = 0; lane < count; ++lane) {
+            result[lane] = ::sqrtf(value[lane]);
+        }
+        return result;
+    }
+
+    static auto reduce_add(const Float& value) -> float
+    {
+        float result = value[0];
+        for(int lane = 1; lane < count; ++lane) {
+            result += value[lane];
+        }
+        return result;
+    }
+
+    static auto reduce_min(const Float& value) -> float
+    {
+        float result = value[0];
+        for(int lane = 1; lane < count; ++lane) {
+            if(value[lane] < result) {
+                result = value[lane];
+            }
+        }
+        return result;
+    }
+
+    static auto reduce_max(const Float& value) -> float
+    {
+        float result = value[0];
+        for(int lane = 1; lane < count; ++lane) {
+            if(value[lane] > result) {
+                result = value[lane];
+            }
+        }
+        return result;
+    }
+
+    static auto any(const Mask& mask) -> bool
+    {
+        for(int lane = 0; lane < count; ++lane) {
+            if(mask[lane] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static auto all(const Mask& mask) -> bool
+    {
+        for(int lane = 0; lane < count; ++lane) {
+            if(mask[lane] == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Lanes
+// ---------------------------------------------------------------------------
+
+template <int N>
+struct Lanes;
+
+template <>
+struct Lanes<4>
+    : public LaneOps<Floatx4, Maskx4, 4>
+{
+};
+
+template <>
+struct Lanes<8>
+    : public LaneOps<Floatx8, Maskx8, 8>
+{
+};
+
+// ---------------------------------------------------------------------------
+// Pos2fxN
+// ---------------------------------------------------------------------------
+
+template <int N>
+struct Pos2fxN
+{
+    using Float = typename Lanes<N>::Float;
+    using Mask  = typename Lanes<N>::Mask;
+
+    Pos2fxN()
+        : x(Float{} + 0.0f)
+        , y(Float{} + 0.0f)
+    {
+    }
+
+    Pos2fxN(float xy)
+        : x(Float{} + xy)
+        , y(Float{} + xy)
+    {
+    }
+
+    Pos2fxN(float vx, float vy)
+        : x(Float{} + vx)
+        , y(Float{} + vy)
+    {
+    }
+
+    Pos2fxN(const Pos2f& position)
+        : x(Float{} + position.x)
+        , y(Float{} + position.y)
+    {
+    }
+
+    Pos2fxN(const Float& vx, const Float& vy)
+        : x(vx)
+        , y(vy)
+    {
+    }
+
+    static auto load(const float* xs, const float* ys) -> Pos2fxN
+    {
+        Pos2fxN result;
+        ::memcpy(&result.x, xs, sizeof(Float));
+        ::memcpy(&result.y, ys, sizeof(Float));
+        return result;
+    }
+
+    static auto load(const float* xs, const float* ys, int count) -> Pos2fxN
+    {
+        Pos2fxN result;
+        for(int lane = 0; lane < count; ++lane) {
+            result.x[lane] = xs[lane];
+            result.y[lane] = ys[lane];
+        }
+        return result;
+    }
+
+    auto store(float* xs, float* ys) const -> void
+    {
+        ::memcpy(xs, &x, sizeof(Float));
+        ::memcpy(ys, &y, sizeof(Float));
+    }
+
+    auto store(float* xs, float* ys, int count) const -> void
+    {
+        for(int lane = 0; lane < count; ++lane) {
+            xs[lane] = x[lane];
+            ys[lane] = y[lane];
+        }
+    }
+
+    auto lane(int index) const -> Pos2f
+    {
+        return Pos2f(x[index], y[index]);
+    }
+
+    Float x;
+    Float y;
+};
+
+// ---------------------------------------------------------------------------
+// Vec2fxN
+// ---------------------------------------------------------------------------
+
+template <int N>
+struct Vec2fxN
+{
+    using Float = typename Lanes<N>::Float;
+    using Mask  = typename Lanes<N>::Mask;
+
+    Vec2fxN()
+        : x(Float{} + 0.0f)
+        , y(Float{} + 0.0f)
+    {
+    }
+
+    Vec2fxN(float xy)
+        : x(Float{} + xy)
+        , y(Float{} + xy)
+    {
+    }
+
+    Vec2fxN(float vx, float vy)
+        : x(Float{} + vx)
+        , y(Float{} + vy)
+    {
+    }
+
+    Vec2fxN(const Vec2f& vector)
+        : x(Float{} + vector.x)
+        , y(Float{} + vector.y)
+    {
+    }
+
+    Vec2fxN(const Float& vx, const Float& vy)
+        : x(vx)
+        , y(vy)
+    {
+    }
+
+    static auto load(const float* xs, const float* ys) -> Vec2fxN
+    {
+        Vec2fxN result;
+        ::memcpy(&result.x, xs, sizeof(Float));
+        ::memcpy(&result.y, ys, sizeof(Float));
+        return result;
+    }
+
+    static auto load(const float* xs, const float* ys, int count) -> Vec2fxN
+    {
+        Vec2fxN result;
+        for(int lane = 0; lane < count; ++lane) {
+            result.x[lane] = xs[lane];
+            result.y[lane] = ys[lane];
+        }
+        return result;
+    }
+
+    auto store(float* xs, float* ys) const -> void
+    {
+        ::memcpy(xs, &x, sizeof(Float));
+        ::memcpy(ys, &y, sizeof(Float));
+    }
+
+    auto store(float* xs, float* ys, int count) const -> void
+    {
+        for(int lane = 0; lane < count; ++lane) {
+            xs[lane] = x[lane];
+            ys[lane] = y[lane];
+        }
+    }
+
+    auto lane(int index) const -> Vec2f
+    {
+        return Vec2f(x[index], y[index]);
+    }
+
+    Float x;
+    Float y;
+};
+
+// ---------------------------------------------------------------------------
+// packed type aliases
+// ---------------------------------------------------------------------------
+
+using Pos2fx4 = Pos2fxN<4>;
+using Vec2fx4 = Vec2fxN<4>;
+using Pos2fx8 = Pos2fxN<8>;
+using Vec2fx8 = Vec2fxN<8>;
+
+// ---------------------------------------------------------------------------
+// Pos2fxN operators
+// ---------------------------------------------------------------------------
+
+template <int N>
+inline auto operator+(const Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>
+{
+    return Pos2fxN<N>((lhs.x + rhs.x), (lhs.y + rhs.y));
+}
+
+template <int N>
+inline auto operator-(const Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>
+{
+    return Pos2fxN<N>((lhs.x - rhs.x), (lhs.y - rhs.y));
+}
+
+template <int N>
+inline auto operator*(const Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>
+{
+    return Pos2fxN<N>((lhs.x * rhs.x), (lhs.y * rhs.y));
+}
+
+template <int N>
+inline auto operator/(const Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>
+{
+    return Pos2fxN<N>((lhs.x / rhs.x), (lhs.y / rhs.y));
+}
+
+template <int N>
+inline auto operator+=(Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>&
+{
+    lhs.x += rhs.x;
+    lhs.y += rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator-=(Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>&
+{
+    lhs.x -= rhs.x;
+    lhs.y -= rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator*=(Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>&
+{
+    lhs.x *= rhs.x;
+    lhs.y *= rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator/=(Pos2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Pos2fxN<N>&
+{
+    lhs.x /= rhs.x;
+    lhs.y /= rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator-(const Pos2fxN<N>& lhs, const Pos2fxN<N>& rhs) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x - rhs.x), (lhs.y - rhs.y));
+}
+
+// ---------------------------------------------------------------------------
+// Vec2fxN operators
+// ---------------------------------------------------------------------------
+
+template <int N>
+inline auto operator+(const Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x + rhs.x), (lhs.y + rhs.y));
+}
+
+template <int N>
+inline auto operator-(const Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x - rhs.x), (lhs.y - rhs.y));
+}
+
+template <int N>
+inline auto operator*(const Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x * rhs.x), (lhs.y * rhs.y));
+}
+
+template <int N>
+inline auto operator/(const Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x / rhs.x), (lhs.y / rhs.y));
+}
+
+template <int N>
+inline auto operator*(const Vec2fxN<N>& lhs, const typename Lanes<N>::Float& value) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x * value), (lhs.y * value));
+}
+
+template <int N>
+inline auto operator/(const Vec2fxN<N>& lhs, const typename Lanes<N>::Float& value) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x / value), (lhs.y / value));
+}
+
+template <int N>
+inline auto operator*(const Vec2fxN<N>& lhs, const float value) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x * value), (lhs.y * value));
+}
+
+template <int N>
+inline auto operator/(const Vec2fxN<N>& lhs, const float value) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>((lhs.x / value), (lhs.y / value));
+}
+
+template <int N>
+inline auto operator+=(Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>&
+{
+    lhs.x += rhs.x;
+    lhs.y += rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator-=(Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>&
+{
+    lhs.x -= rhs.x;
+    lhs.y -= rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator*=(Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>&
+{
+    lhs.x *= rhs.x;
+    lhs.y *= rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator/=(Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>&
+{
+    lhs.x /= rhs.x;
+    lhs.y /= rhs.y;
+    return lhs;
+}
+
+template <int N>
+inline auto operator*=(Vec2fxN<N>& lhs, const typename Lanes<N>::Float& value) -> Vec2fxN<N>&
+{
+    lhs.x *= value;
+    lhs.y *= value;
+    return lhs;
+}
+
+template <int N>
+inline auto operator/=(Vec2fxN<N>& lhs, const typename Lanes<N>::Float& value) -> Vec2fxN<N>&
+{
+    lhs.x /= value;
+    lhs.y /= value;
+    return lhs;
+}
+
+template <int N>
+inline auto operator*=(Vec2fxN<N>& lhs, const float value) -> Vec2fxN<N>&
+{
+    lhs.x *= value;
+    lhs.y *= value;
+    return lhs;
+}
+
+template <int N>
+inline auto operator/=(Vec2fxN<N>& lhs, const float value) -> Vec2fxN<N>&
+{
+    lhs.x /= value;
+    lhs.y /= value;
+    return lhs;
+}
+
+// ---------------------------------------------------------------------------
+// Floatx4/Floatx8 functions
+// ---------------------------------------------------------------------------
+
+inline auto select(const Maskx4& mask, const Floatx4& lhs, const Floatx4& rhs) -> Floatx4
+{
+    return Lanes<4>::select(mask, lhs, rhs);
+}
+
+inline auto select(const Maskx8& mask, const Floatx8& lhs, const Floatx8& rhs) -> Floatx8
+{
+    return Lanes<8>::select(mask, lhs, rhs);
+}
+
+inline auto reduce_add(const Floatx4& value) -> float
+{
+    return Lanes<4>::reduce_add(value);
+}
+
+inline auto reduce_add(const Floatx8& value) -> float
+{
+    return Lanes<8>::reduce_add(value);
+}
+
+inline auto reduce_min(const Floatx4& value) -> float
+{
+    return Lanes<4>::reduce_min(value);
+}
+
+inline auto reduce_min(const Floatx8& value) -> float
+{
+    return Lanes<8>::reduce_min(value);
+}
+
+inline auto reduce_max(const Floatx4& value) -> float
+{
+    return Lanes<4>::reduce_max(value);
+}
+
+inline auto reduce_max(const Floatx8& value) -> float
+{
+    return Lanes<8>::reduce_max(value);
+}
+
+inline auto any(const Maskx4& mask) -> bool
+{
+    return Lanes<4>::any(mask);
+}
+
+inline auto any(const Maskx8& mask) -> bool
+{
+    return Lanes<8>::any(mask);
+}
+
+inline auto all(const Maskx4& mask) -> bool
+{
+    return Lanes<4>::all(mask);
+}
+
+inline auto all(const Maskx8& mask) -> bool
+{
+    return Lanes<8>::all(mask);
+}
+
+// ---------------------------------------------------------------------------
+// Pos2fxN/Vec2fxN functions
+// ---------------------------------------------------------------------------
+
+template <int N>
+inline auto select(const typename Lanes<N>::Mask& mask, const Pos2fxN<N>& lhs, const Pos2fxN<N>& rhs) -> Pos2fxN<N>
+{
+    return Pos2fxN<N>(Lanes<N>::select(mask, lhs.x, rhs.x), Lanes<N>::select(mask, lhs.y, rhs.y));
+}
+
+template <int N>
+inline auto select(const typename Lanes<N>::Mask& mask, const Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>(Lanes<N>::select(mask, lhs.x, rhs.x), Lanes<N>::select(mask, lhs.y, rhs.y));
+}
+
+template <int N>
+inline auto reduce_add(const Vec2fxN<N>& vector) -> Vec2f
+{
+    return Vec2f(Lanes<N>::reduce_add(vector.x), Lanes<N>::reduce_add(vector.y));
+}
+
+template <int N>
+inline auto dot(const Vec2fxN<N>& lhs, const Vec2fxN<N>& rhs) -> typename Lanes<N>::Float
+{
+    return (lhs.x * rhs.x) + (lhs.y * rhs.y);
+}
+
+template <int N>
+inline auto length(const Vec2fxN<N>& vector) -> typename Lanes<N>::Float
+{
+    return Lanes<N>::sqrt((vector.x * vector.x) + (vector.y * vector.y));
+}
+
+template <int N>
+inline auto normalize(const Vec2fxN<N>& vector) -> Vec2fxN<N>
+{
+    using Float = typename Lanes<N>::Float;
+    using Mask  = typename Lanes<N>::Mask;
+
+    const Float length = Lanes<N>::sqrt((vector.x * vector.x) + (vector.y * vector.y));
+    const Mask  valid  = (length != 0.0f);
+    const Float scale  = 1.0f / Lanes<N>::select(valid, length, (Float{} + 1.0f));
+
+    return select(valid, Vec2fxN<N>((vector.x * scale), (vector.y * scale)), Vec2fxN<N>());
+}
+
+template <int N>
+inline auto perpendicular(const Vec2fxN<N>& vector) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>(-vector.y, +vector.x);
+}
+
+template <int N>
+inline auto reflect(const Vec2fxN<N>& vector, const Vec2fxN<N>& normal) -> Vec2fxN<N>
+{
+    return Vec2fxN<N>(vector - (normal * (2.0f * dot(vector, normal))));
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 // ---------------------------------------------------------------------------
 // End-Of-File
 // ---------------------------------------------------------------------------
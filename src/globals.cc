@@ -81,6 +81,29 @@ float Globals::poly_gravity  = GravityType::NONE;
 float Globals::ball_radius   =   65.00f;
 float Globals::ball_friction =    0.25f;
 float Globals::ball_gravity  = GravityType::EARTH;
+bool  Globals::fast_math     = false;
+bool  Globals::fixed_point   = false;
+bool  Globals::benchmark     = false;
+bool  Globals::selftest      = false;
+bool  Globals::stats         = false;
+bool  Globals::alloc_assert  = false;
+int   Globals::ball_count    =    1;
+bool  Globals::headless      = false;
+int   Globals::headless_steps = 10000;
+float Globals::headless_dtime =   0.005f;
+bool  Globals::threaded      = false;
+int   Globals::pacing        =    0;
+bool  Globals::idle          = true;
+float Globals::time_scale    =    1.0f;
+float Globals::target_frame  =    0.0f;
+int   Globals::affinity      =   -1;
+int   Globals::sched_policy  = SchedType::OTHER;
+bool  Globals::mlock         = false;
+bool  Globals::prefault      = false;
+bool  Globals::software      = false;
+bool  Globals::dirty_rects   = true;
+int   Globals::present_mode  = PresentType::VSYNC;
+int   Globals::trail_length  =    0;
 #else
 int   Globals::app_width     = 1280;
 int   Globals::app_height    =  720;
@@ -92,6 +115,29 @@ float Globals::poly_gravity  = GravityType::NONE;
 float Globals::ball_radius   =  100.00f;
 float Globals::ball_friction =    0.25f;
 float Globals::ball_gravity  = GravityType::EARTH;
+bool  Globals::fast_math     = false;
+bool  Globals::fixed_point   = false;
+bool  Globals::benchmark     = false;
+bool  Globals::selftest      = false;
+bool  Globals::stats         = false;
+bool  Globals::alloc_assert  = false;
+int   Globals::ball_count    =    1;
+bool  Globals::headless      = false;
+int   Globals::headless_steps = 10000;
+float Globals::headless_dtime =   0.005f;
+bool  Globals::threaded      = false;
+int   Globals::pacing        =    0;
+bool  Globals::idle          = true;
+float Globals::time_scale    =    1.0f;
+float Globals::target_frame  =    0.0f;
+int   Globals::affinity      =   -1;
+int   Globals::sched_policy  = SchedType::OTHER;
+bool  Globals::mlock         = false;
+bool  Globals::prefault      = false;
+bool  Globals::software      = false;
+bool  Globals::dirty_rects   = true;
+int   Globals::present_mode  = PresentType::VSYNC;
+int   Globals::trail_length  =    0;
 #endif
 
 // ---------------------------------------------------------------------------
@@ -110,6 +156,29 @@ auto Globals::init() -> void
     set_ball_radius(ball_radius);
     set_ball_friction(ball_friction);
     set_ball_gravity(ball_gravity);
+    set_fast_math(fast_math);
+    set_fixed_point(fixed_point);
+    set_benchmark(benchmark);
+    set_selftest(selftest);
+    set_stats(stats);
+    set_alloc_assert(alloc_assert);
+    set_ball_count(ball_count);
+    set_headless(headless);
+    set_headless_steps(headless_steps);
+    set_headless_dtime(headless_dtime);
+    set_threaded(threaded);
+    set_pacing(pacing);
+    set_idle(idle);
+    set_time_scale(time_scale);
+    set_target_frame(target_frame);
+    set_affinity(affinity);
+    set_sched_policy(sched_policy);
+    set_mlock(mlock);
+    set_prefault(prefault);
+    set_software(software);
+    set_dirty_rects(dirty_rects);
+    set_present_mode(present_mode);
+    set_trail_length(trail_length);
 }
 
 auto Globals::set_app_width(int m_app_width) -> void
@@ -162,6 +231,162 @@ auto Globals::set_ball_gravity(float m_ball_gravity) -> void
     ball_gravity = clampf(m_ball_gravity, GlobalsMin::ball_gravity, GlobalsMax::ball_gravity);
 }
 
+auto Globals::set_fast_math(bool m_fast_math) -> void
+{
+    fast_math = m_fast_math;
+}
+
+auto Globals::set_fixed_point(bool m_fixed_point) -> void
+{
+    fixed_point = m_fixed_point;
+}
+
+auto Globals::set_benchmark(bool m_benchmark) -> void
+{
+    benchmark = m_benchmark;
+}
+
+auto Globals::set_selftest(bool m_selftest) -> void
+{
+    selftest = m_selftest;
+}
+
+auto Globals::set_stats(bool m_stats) -> void
+{
+    stats = m_stats;
+}
+
+auto Globals::set_alloc_assert(bool m_alloc_assert) -> void
+{
+    alloc_assert = m_alloc_assert;
+}
+
+auto Globals::set_ball_count(int m_ball_count) -> void
+{
+    ball_count = clampi(m_ball_count, GlobalsMin::ball_count, GlobalsMax::ball_count);
+}
+
+auto Globals::set_headless(bool m_headless) -> void
+{
+    headless = m_headless;
+}
+
+auto Globals::set_headless_steps(int m_headless_steps) -> void
+{
+    headless_steps = clampi(m_headless_steps, GlobalsMin::headless_steps, GlobalsMax::headless_steps);
+}
+
+auto Globals::set_headless_dtime(float m_headless_dtime) -> void
+{
+    headless_dtime = clampf(m_headless_dtime, GlobalsMin::headless_dtime, GlobalsMax::headless_dtime);
+}
+
+auto Globals::set_threaded(bool m_threaded) -> void
+{
+#ifdef __EMSCRIPTEN__
+    threaded = false;
+#else
+    threaded = m_threaded;
+#endif
+}
+
+auto Globals::set_pacing(int m_pacing) -> void
+{
+#ifdef __EMSCRIPTEN__
+    pacing = 0;
+#else
+    pacing = clampi(m_pacing, GlobalsMin::pacing, GlobalsMax::pacing);
+#endif
+}
+
+auto Globals::set_idle(bool m_idle) -> void
+{
+    idle = m_idle;
+}
+
+auto Globals::set_time_scale(float m_time_scale) -> void
+{
+    time_scale = clampf(m_time_scale, GlobalsMin::time_scale, GlobalsMax::time_scale);
+}
+
+auto Globals::set_target_frame(float m_target_frame) -> void
+{
+    target_frame = clampf(m_target_frame, GlobalsMin::target_frame, GlobalsMax::target_frame);
+}
+
+auto Globals::set_affinity(int m_affinity) -> void
+{
+#ifdef __EMSCRIPTEN__
+    affinity = -1;
+#else
+    affinity = clampi(m_affinity, GlobalsMin::affinity, GlobalsMax::affinity);
+#endif
+}
+
+auto Globals::set_sched_policy(int m_sched_policy) -> void
+{
+#ifdef __EMSCRIPTEN__
+    sched_policy = SchedType::OTHER;
+#else
+    switch(m_sched_policy) {
+        case SchedType::FIFO:
+        case SchedType::RR:
+            sched_policy = m_sched_policy;
+            break;
+        default:
+            sched_policy = SchedType::OTHER;
+            break;
+    }
+#endif
+}
+
+auto Globals::set_mlock(bool m_mlock) -> void
+{
+#ifdef __EMSCRIPTEN__
+    mlock = false;
+#else
+    mlock = m_mlock;
+#endif
+}
+
+auto Globals::set_prefault(bool m_prefault) -> void
+{
+    prefault = m_prefault;
+}
+
+auto Globals::set_software(bool m_software) -> void
+{
+    software = m_software;
+}
+
+auto Globals::set_dirty_rects(bool m_dirty_rects) -> void
+{
+    dirty_rects = m_dirty_rects;
+}
+
+auto Globals::set_present_mode(int m_present_mode) -> void
+{
+#ifdef __EMSCRIPTEN__
+    present_mode = PresentType::VSYNC;
+#else
+    switch(m_present_mode) {
+        case PresentType::IMMEDIATE:
+        case PresentType::CAPPED:
+        case PresentType::LATEST:
+            present_mode = m_present_mode;
+            break;
+        default:
+            present_mode = PresentType::VSYNC;
+            break;
+    }
+#endif
+}
+
+auto Globals::set_trail_length(int m_trail_length) -> void
+{
+    trail_length = clampi(m_trail_length, GlobalsMin::trail_length, GlobalsMax::trail_length);
+}
+
 // ---------------------------------------------------------------------------
 // End-Of-File
 // ---------------------------------------------------------------------------
@@ -45,6 +45,52 @@ struct Globals
 
     static auto set_ball_gravity(float ball_gravity) -> void;
 
+    static auto set_fast_math(bool fast_math) -> void;
+
+    static auto set_fixed_point(bool fixed_point) -> void;
+
+    static auto set_benchmark(bool benchmark) -> void;
+
+    static auto set_selftest(bool selftest) -> void;
+
+    static auto set_stats(bool stats) -> void;
+
+    static auto set_alloc_assert(bool alloc_assert) -> void;
+
+    static auto set_ball_count(int ball_count) -> void;
+
+    static auto set_headless(bool headless) -> void;
+
+    static auto set_headless_steps(int headless_steps) -> void;
+
+    static auto set_headless_dtime(float headless_dtime) -> void;
+
+    static auto set_threaded(bool threaded) -> void;
+
+    static auto set_pacing(int pacing) -> void;
+
+    static auto set_idle(bool idle) -> void;
+
+    static auto set_time_scale(float time_scale) -> void;
+
+    static auto set_target_frame(float target_frame) -> void;
+
+    static auto set_affinity(int affinity) -> void;
+
+    static auto set_sched_policy(int sched_policy) -> void;
+
+    static auto set_mlock(bool mlock) -> void;
+
+    static auto set_prefault(bool prefault) -> void;
+
+    static auto set_software(bool software) -> void;
+
+    static auto set_dirty_rects(bool dirty_rects) -> void;
+
+    static auto set_present_mode(int present_mode) -> void;
+
+    static auto set_trail_length(int trail_length) -> void;
+
     static int   app_width;
     static int   app_height;
     static int   poly_vertices;
@@ -55,6 +101,29 @@ struct Globals
     static float ball_radius;
     static float ball_friction;
     static float ball_gravity;
+    static bool  fast_math;
+    static bool  fixed_point;
+    static bool  benchmark;
+    static bool  selftest;
+    static bool  stats;
+    static bool  alloc_assert;
+    static int   ball_count;
+    static bool  headless;
+    static int   headless_steps;
+    static float headless_dtime;
+    static bool  threaded;
+    static int   pacing;
+    static bool  idle;
+    static float time_scale;
+    static float target_frame;
+    static int   affinity;
+    static int   sched_policy;
+    static bool  mlock;
+    static bool  prefault;
+    static bool  software;
+    static bool  dirty_rects;
+    static int   present_mode;
+    static int   trail_length;
 };
 
 // ---------------------------------------------------------------------------
@@ -73,6 +142,14 @@ struct GlobalsMin
     static constexpr float ball_radius   =   25.0f;
     static constexpr float ball_friction =    0.0f;
     static constexpr float ball_gravity  =    0.0f;
+    static constexpr int   ball_count    =    1;
+    static constexpr int   headless_steps =   1;
+    static constexpr float headless_dtime =   0.0001f;
+    static constexpr int   pacing        =    0;
+    static constexpr float time_scale    =    0.1f;
+    static constexpr float target_frame  =    0.0f;
+    static constexpr int   affinity      =   -1;
+    static constexpr int   trail_length  =    0;
 };
 
 // ---------------------------------------------------------------------------
@@ -91,6 +168,14 @@ struct GlobalsMax
     static constexpr float ball_radius   =  250.0f;
     static constexpr float ball_friction =   10.0f;
     static constexpr float ball_gravity  = 9999.0f;
+    static constexpr int   ball_count    = 100000;
+    static constexpr int   headless_steps = 1000000000;
+    static constexpr float headless_dtime =    0.1f;
+    static constexpr int   pacing        = 1000;
+    static constexpr float time_scale    = 1000.0f;
+    static constexpr float target_frame  = 1000.0f;
+    static constexpr int   affinity      = 1023;
+    static constexpr int   trail_length  =  100;
 };
 
 // ---------------------------------------------------------------------------
@@ -111,6 +196,30 @@ struct PolygonType
     static constexpr int DODECAGON  = 12;
 };
 
+// ---------------------------------------------------------------------------
+// SchedType
+// ---------------------------------------------------------------------------
+
+struct SchedType
+{
+    static constexpr int OTHER = 0;
+    static constexpr int FIFO  = 1;
+    static constexpr int RR    = 2;
+};
+
+// ---------------------------------------------------------------------------
+// PresentType
+// ---------------------------------------------------------------------------
+
+struct PresentType
+{
+    static constexpr int VSYNC     = 0;
+    static constexpr int IMMEDIATE = 1;
+    static constexpr int CAPPED    = 2;
+    static constexpr int LATEST    = 3;
+    static constexpr int COUNT     = 4;
+};
+
 // ---------------------------------------------------------------------------
 // GravityType
 // ---------------------------------------------------------------------------
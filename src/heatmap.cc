@@ -0,0 +1,258 @@
+/*
+ * heatmap.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "globals.h"
+#include "heatmap.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::constants
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int   lane_count      = 8;
+constexpr int   cell_size       = 8;
+constexpr int   upload_period   = 8;
+constexpr float half_life_steps = 1200.0f;
+constexpr float max_alpha       = 0.75f;
+constexpr float max_weight      = 1e18f;
+
+/*
+ * ramp from transparent blue to opaque yellow through red, the intensity
+ * being the square root of the occupancy relative to the busiest cell
+ */
+auto heat(float intensity) -> uint32_t
+{
+    const float    t = ::sqrtf(intensity);
+    const uint32_t r = uint32_t(255.0f * std::min(1.0f, (2.0f * t)));
+    const uint32_t g = uint32_t(255.0f * std::max(0.0f, ((2.0f * t) - 1.0f)));
+    const uint32_t b = uint32_t(255.0f * std::max(0.0f, (1.0f - (2.0f * t))));
+    const uint32_t a = uint32_t(255.0f * max_alpha * t);
+
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Occupancy
+// ---------------------------------------------------------------------------
+
+Occupancy::Occupancy()
+    : _cells()
+    , _cols((GlobalsMax::app_width  + (cell_size - 1)) / cell_size)
+    , _rows((GlobalsMax::app_height + (cell_size - 1)) / cell_size)
+    , _weight(1.0f)
+    , _steps(0)
+{
+    _cells.assign(((((_cols * _rows) + (lane_count - 1)) / lane_count) * lane_count), 0.0f);
+}
+
+auto Occupancy::clear() -> void
+{
+    if(_steps == 0) {
+        return;
+    }
+    std::fill(_cells.begin(), _cells.end(), 0.0f);
+    _weight = 1.0f;
+    _steps  = 0;
+}
+
+/*
+ * increments the cell under every ball by the weight of the step, which
+ * grows so that the previous steps are decayed relative to this one
+ */
+auto Occupancy::record(const World& world) -> void
+{
+    const float scale  = (1.0f / float(cell_size));
+    const float growth = ::powf(2.0f, (1.0f / half_life_steps));
+
+    if(_weight > max_weight) {
+        rebase();
+    }
+    _weight *= growth;
+    for(auto& ball : world.balls()) {
+        const int col = int(::floorf(ball.position().x * scale));
+        const int row = int(::floorf(ball.position().y * scale));
+        if((col >= 0) && (col < _cols) && (row >= 0) && (row < _rows)) {
+            _cells[(row * _cols) + col] += _weight;
+        }
+    }
+    ++_steps;
+}
+
+auto Occupancy::rebase() -> void
+{
+    const int   size   = int(_cells.size());
+    const float factor = (1.0f / _weight);
+
+    for(int index = 0; index < size; index += lane_count) {
+        Floatx8 cells;
+        ::memcpy(&cells, &_cells[index], sizeof(cells));
+        cells *= factor;
+        ::memcpy(&_cells[index], &cells, sizeof(cells));
+    }
+    _weight = 1.0f;
+}
+
+// ---------------------------------------------------------------------------
+// Heatmap
+// ---------------------------------------------------------------------------
+
+Heatmap::Heatmap(int width, int height)
+    : _cells()
+    , _pixels()
+    , _width(0)
+    , _height(0)
+    , _cols(0)
+    , _rows(0)
+    , _frame(0)
+    , _time(0)
+    , _frames(0)
+{
+    const int cols = ((GlobalsMax::app_width  + (cell_size - 1)) / cell_size);
+    const int rows = ((GlobalsMax::app_height + (cell_size - 1)) / cell_size);
+
+    _cells.reserve((cols * rows) + lane_count);
+    _pixels.reserve(cols * rows);
+    resize(width, height);
+}
+
+auto Heatmap::clear() -> void
+{
+    std::fill(_cells.begin(), _cells.end(), 0.0f);
+    _frame = 0;
+}
+
+/*
+ * sizes the grid to cover the given extent of the world from its origin,
+ * the cells being padded to a whole number of lanes
+ */
+auto Heatmap::resize(int width, int height) -> void
+{
+    if((width == _width) && (height == _height)) {
+        return;
+    }
+    _width  = width;
+    _height = height;
+    _cols   = std::max(1, ((width  + (cell_size - 1)) / cell_size));
+    _rows   = std::max(1, ((height + (cell_size - 1)) / cell_size));
+    _cells.assign(((((_cols * _rows) + (lane_count - 1)) / lane_count) * lane_count), 0.0f);
+    _pixels.assign((_cols * _rows), 0);
+    _frame = 0;
+}
+
+/*
+ * merges the occupancy recorded since the last frame: the decay of its steps
+ * compounded over the grid, then its cells brought back to the weight of a
+ * single step and added to the overlapping cells
+ */
+auto Heatmap::update(const Occupancy& occupancy) -> void
+{
+    if(occupancy.steps() <= 0) {
+        return;
+    }
+    const uint64_t start = ::SDL_GetPerformanceCounter();
+    const float    scale = (1.0f / occupancy.weight());
+    const int      cols  = std::min(_cols, occupancy.cols());
+    const int      rows  = std::min(_rows, occupancy.rows());
+    const float*   cells = occupancy.cells().data();
+
+    decay(::powf(0.5f, (float(occupancy.steps()) / half_life_steps)));
+    for(int row = 0; row < rows; ++row) {
+        float*       dst = &_cells[row * _cols];
+        const float* src = &cells[row * occupancy.cols()];
+        for(int col = 0; col < cols; ++col) {
+            dst[col] += (src[col] * scale);
+        }
+    }
+    _time += (::SDL_GetPerformanceCounter() - start);
+}
+
+/*
+ * hands the grid over to the canvas once every few frames, the texture
+ * being uploaded and the background drawn again only then
+ */
+auto Heatmap::render(Canvas& canvas) -> void
+{
+    const uint64_t start = ::SDL_GetPerformanceCounter();
+
+    if((_frame++ % upload_period) == 0) {
+        colorize();
+        canvas.update_heatmap(_pixels.data(), _cols, _rows, float(cell_size));
+    }
+    _time += (::SDL_GetPerformanceCounter() - start);
+    ++_frames;
+}
+
+auto Heatmap::decay(float factor) -> void
+{
+    const int size = int(_cells.size());
+
+    for(int index = 0; index < size; index += lane_count) {
+        Floatx8 cells;
+        ::memcpy(&cells, &_cells[index], sizeof(cells));
+        cells *= factor;
+        ::memcpy(&_cells[index], &cells, sizeof(cells));
+    }
+}
+
+/*
+ * the cells are normalized by the busiest one, so that the ramp does not
+ * depend on the number of balls nor on how long the heatmap has been shown
+ */
+auto Heatmap::colorize() -> void
+{
+    const int size  = int(_cells.size());
+    const int count = (_cols * _rows);
+    Floatx8   peak  = (Floatx8{} + 0.0f);
+
+    for(int index = 0; index < size; index += lane_count) {
+        Floatx8 cells;
+        ::memcpy(&cells, &_cells[index], sizeof(cells));
+        peak = ((cells > peak) ? cells : peak);
+    }
+    const float highest = Lanes<8>::reduce_max(peak);
+    const float scale   = (highest > 0.0f ? (1.0f / highest) : 0.0f);
+    for(int index = 0; index < count; ++index) {
+        _pixels[index] = heat(_cells[index] * scale);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
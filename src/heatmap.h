@@ -0,0 +1,162 @@
+/*
+ * heatmap.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Heatmap_h__
+#define __Heatmap_h__
+
+#include "world.h"
+
+// ---------------------------------------------------------------------------
+// Occupancy
+//
+// cells under the balls recorded at every simulation step, on the thread that
+// runs the simulation, until handed over to the heatmap. The grid covers the
+// largest window with the cells of the heatmap. Rather than decaying the whole
+// grid at every step, each step is recorded with a weight growing by the
+// inverse of the decay, so that the grid divided by the current weight is the
+// decayed occupancy; the weight is brought back to one before it overflows.
+// ---------------------------------------------------------------------------
+
+class Occupancy
+{
+public: // public interface
+    Occupancy();
+
+    Occupancy(const Occupancy&) = delete;
+
+    Occupancy& operator=(const Occupancy&) = delete;
+
+    virtual ~Occupancy() = default;
+
+    auto clear() -> void;
+
+    auto record(const World& world) -> void;
+
+public: // public accessors
+    auto cells() const -> const std::vector<float>&
+    {
+        return _cells;
+    }
+
+    auto cols() const -> int
+    {
+        return _cols;
+    }
+
+    auto rows() const -> int
+    {
+        return _rows;
+    }
+
+    auto weight() const -> float
+    {
+        return _weight;
+    }
+
+    auto steps() const -> int
+    {
+        return _steps;
+    }
+
+private: // private interface
+    auto rebase() -> void;
+
+private: // private data
+    std::vector<float> _cells;
+    int                _cols;
+    int                _rows;
+    float              _weight;
+    int                _steps;
+};
+
+// ---------------------------------------------------------------------------
+// Heatmap
+//
+// occupancy of the world accumulated into a grid of coarse cells, so that a
+// cell holds the time spent there by the balls, weighted towards the recent
+// past with a constant decay per simulation step. The occupancy recorded by
+// the simulation steps is merged once per frame, and the grid is turned into
+// pixels and handed over to the canvas only once every few frames.
+// ---------------------------------------------------------------------------
+
+class Heatmap
+{
+public: // public interface
+    Heatmap(int width, int height);
+
+    Heatmap(const Heatmap&) = delete;
+
+    Heatmap& operator=(const Heatmap&) = delete;
+
+    virtual ~Heatmap() = default;
+
+    auto clear() -> void;
+
+    auto resize(int width, int height) -> void;
+
+    auto update(const Occupancy& occupancy) -> void;
+
+    auto render(Canvas& canvas) -> void;
+
+public: // public accessors
+    auto cols() const -> int
+    {
+        return _cols;
+    }
+
+    auto rows() const -> int
+    {
+        return _rows;
+    }
+
+    auto time() const -> uint64_t
+    {
+        return _time;
+    }
+
+    auto frames() const -> uint32_t
+    {
+        return _frames;
+    }
+
+    auto reset_time() -> void
+    {
+        _time   = 0;
+        _frames = 0;
+    }
+
+private: // private interface
+    auto decay(float factor) -> void;
+
+    auto colorize() -> void;
+
+private: // private data
+    std::vector<float>    _cells;
+    std::vector<uint32_t> _pixels;
+    int                   _width;
+    int                   _height;
+    int                   _cols;
+    int                   _rows;
+    int                   _frame;
+    uint64_t              _time;
+    uint32_t              _frames;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Heatmap_h__ */
@@ -0,0 +1,112 @@
+/*
+ * latency.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "globals.h"
+#include "latency.h"
+
+
+// ---------------------------------------------------------------------------
+// Latency
+// ---------------------------------------------------------------------------
+
+Latency::Latency()
+    : _buckets()
+    , _count(0)
+    , _worst(0)
+{
+}
+
+auto Latency::add(uint32_t latency) -> void
+{
+    const uint32_t bucket = (latency < bucket_count ? latency : (bucket_count - 1));
+
+    ++_buckets[bucket];
+    ++_count;
+    if(latency > _worst) {
+        _worst = latency;
+    }
+}
+
+auto Latency::reset() -> void
+{
+    for(auto& bucket : _buckets) {
+        bucket = 0;
+    }
+    _count = 0;
+    _worst = 0;
+}
+
+auto Latency::percentile(double percent) const -> uint32_t
+{
+    const uint64_t rank  = uint64_t(::ceil((percent / 100.0) * double(_count)));
+    uint64_t       total = 0;
+
+    for(uint32_t bucket = 0; bucket < bucket_count; ++bucket) {
+        total += _buckets[bucket];
+        if((total >= rank) && (total != 0)) {
+            return (bucket < (bucket_count - 1) ? bucket : _worst);
+        }
+    }
+    return _worst;
+}
+
+auto Latency::print(std::ostream& stream) const -> void
+{
+    constexpr uint64_t bar_width = 40;
+    uint64_t           highest   = 0;
+
+    for(auto& bucket : _buckets) {
+        if(bucket > highest) {
+            highest = bucket;
+        }
+    }
+    stream << "input latency: " << _count << " samples"
+           << ", p50 "   << percentile(50.0) << " ms"
+           << ", p99 "   << percentile(99.0) << " ms"
+           << ", worst " << _worst           << " ms" << std::endl;
+    for(uint32_t bucket = 0; bucket < bucket_count; ++bucket) {
+        if(_buckets[bucket] != 0) {
+            const uint64_t width = ((_buckets[bucket] * bar_width) + (highest - 1)) / highest;
+            stream << (bucket < (bucket_count - 1) ? "  " : ">=")
+                   << bucket << " ms ... " << _buckets[bucket] << ' '
+                   << std::string(width, '#') << std::endl;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+/*
+ * latency.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Latency_h__
+#define __Latency_h__
+
+// ---------------------------------------------------------------------------
+// Latency
+//
+// histogram of the input-to-photon latencies, in milliseconds, from the SDL
+// timestamp of an input event to the presentation of its first effect.
+// ---------------------------------------------------------------------------
+
+class Latency
+{
+public: // public interface
+    Latency();
+
+    Latency(const Latency&) = delete;
+
+    Latency& operator=(const Latency&) = delete;
+
+    virtual ~Latency() = default;
+
+    auto add(uint32_t latency) -> void;
+
+    auto reset() -> void;
+
+    auto percentile(double percent) const -> uint32_t;
+
+    auto print(std::ostream& stream) const -> void;
+
+public: // public accessors
+    auto count() const -> uint64_t
+    {
+        return _count;
+    }
+
+    auto worst() const -> uint32_t
+    {
+        return _worst;
+    }
+
+private: // private data
+    static constexpr uint32_t bucket_count = 256;
+
+    uint64_t _buckets[bucket_count];
+    uint64_t _count;
+    uint32_t _worst;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Latency_h__ */
@@ -34,6 +34,8 @@
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
+#include "globals.h"
+#include "fixed.h"
 #include "objects.h"
 
 // ---------------------------------------------------------------------------
@@ -50,23 +52,39 @@ Object::Object(const Pos2f& position, const Col4i& color)
 {
 }
 
+auto Object::assign(const Object& object) -> void
+{
+    _position = object._position;
+    _velocity = object._velocity;
+    _friction = object._friction;
+    _gravity  = object._gravity;
+    _color    = object._color;
+    _frozen   = object._frozen;
+}
+
 // ---------------------------------------------------------------------------
 // Poly
 // ---------------------------------------------------------------------------
 
 Poly::Poly(const Pos2f& position, int vertices, float radius)
     : Object(position, Col4i(1.00f, 1.00f, 1.00f))
-    , _vertices(vertices)
+    , _vertices()
     , _radius(radius)
     , _omega(0.0f)
     , _angle(0.0f)
 {
+    _vertices.reserve(GlobalsMax::poly_vertices);
+    _vertices.resize(vertices);
 }
 
 void Poly::update(const float dt)
 {
     constexpr float m_2pi = 2.0f * M_PI;
 
+    if(Globals::fixed_point != false) {
+        return update_fixed(dt);
+    }
+
     auto update_poly = [&]() -> void
     {
         int       index = 0;
@@ -94,22 +112,86 @@ void Poly::update(const float dt)
     }
 }
 
-void Poly::render(Canvas& canvas)
+auto Poly::update_fixed(const float dt) -> void
+{
+    const Fixed m_2pi(Fixed::from_raw(Fixed::raw_two_pi));
+    const Fixed step(dt);
+    const Fixed one(1);
+
+    auto update_poly = [&](const Pos2x& position, const Fixed& angle) -> void
+    {
+        const Fixed radius(_radius);
+        const int   count = _vertices.size();
+        int         index = 0;
+        for(auto& vertex : _vertices) {
+            const Fixed vertex_angle(angle + ((m_2pi / count) * index));
+            vertex = (position + Vec2x((radius * cos(vertex_angle)), (radius * sin(vertex_angle)))).to_float();
+            ++index;
+        }
+    };
+
+    if(_frozen == false) {
+        Pos2x position(_position);
+        Vec2x velocity(_velocity);
+        Fixed angle(_angle);
+        velocity += (Vec2x(_gravity) * step);
+        position += (velocity * step);
+        velocity *= (Vec2x(one) - (Vec2x(_friction) * step));
+        angle    += (Fixed(_omega) * step);
+        while(angle >= +m_2pi) {
+            angle -= m_2pi;
+        }
+        while(angle <= -m_2pi) {
+            angle += m_2pi;
+        }
+        _position = position.to_float();
+        _velocity = velocity.to_float();
+        _angle    = angle.to_float();
+        update_poly(position, angle);
+    }
+}
+
+auto Poly::assign(const Poly& poly) -> void
 {
+    Object::assign(poly);
+
+    _vertices.assign(poly._vertices.begin(), poly._vertices.end());
+    _radius = poly._radius;
+    _omega  = poly._omega;
+    _angle  = poly._angle;
+}
+
+/*
+ * the polygon is culled as a whole from its bounding box, and drawn as a
+ * point when it is smaller than a pixel. The offset shifts the drawing only,
+ * not the simulated polygon.
+ */
+void Poly::render(Canvas& canvas, const Vec2f& offset)
+{
+    const Pos2f position(_position + offset);
+
     auto render_poly = [&]() -> void
     {
-        const Pos2f* prev(&(*rbegin()));
+        Pos2f prev(*rbegin() + offset);
         for(auto& vertex : _vertices) {
-            const int x1 = int((*prev).x);
-            const int y1 = int((*prev).y);
-            const int x2 = int(vertex.x);
-            const int y2 = int(vertex.y);
-            canvas.line(x1, y1, x2, y2);
-            prev = &vertex;
+            const Pos2f curr(vertex + offset);
+            canvas.line(prev.x, prev.y, curr.x, curr.y);
+            prev = curr;
         }
     };
 
+    auto render_point = [&]() -> void
+    {
+        canvas.point(position.x, position.y);
+    };
+
+    if(canvas.visible((position.x - _radius), (position.y - _radius), (position.x + _radius), (position.y + _radius)) == false) {
+        return;
+    }
     canvas.color(_color);
+    if(canvas.subpixel(_radius) != false) {
+        return render_point();
+    }
     render_poly();
 }
 
@@ -125,6 +207,9 @@ Ball::Ball(const Pos2f& position, float radius)
 
 void Ball::update(const float dt)
 {
+    if(Globals::fixed_point != false) {
+        return update_fixed(dt);
+    }
     if(_frozen == false) {
         _velocity += (_gravity * dt);
         _position += (_velocity * dt);
@@ -132,16 +217,53 @@ void Ball::update(const float dt)
     }
 }
 
-void Ball::render(Canvas& canvas)
+auto Ball::update_fixed(const float dt) -> void
 {
+    const Fixed step(dt);
+    const Fixed one(1);
+
+    if(_frozen == false) {
+        Pos2x position(_position);
+        Vec2x velocity(_velocity);
+        velocity += (Vec2x(_gravity) * step);
+        position += (velocity * step);
+        velocity *= (Vec2x(one) - (Vec2x(_friction) * step));
+        _position = position.to_float();
+        _velocity = velocity.to_float();
+    }
+}
+
+auto Ball::assign(const Ball& ball) -> void
+{
+    Object::assign(ball);
+
+    _radius = ball._radius;
+}
+
+void Ball::render(Canvas& canvas, const Vec2f& offset)
+{
+    const Pos2f position(_position + offset);
+
     canvas.color(_color);
-    canvas.circle(_position.x, _position.y, _radius);
+    canvas.sprite(position.x, position.y, _radius);
 }
 
-void Ball::collide(const Poly& poly)
+void Ball::collide(const Poly& poly, Contacts* contacts)
 {
     constexpr float epsilon = std::numeric_limits<float>::epsilon();
 
+    if(Globals::fixed_point != false) {
+        return collide_fixed(poly, contacts);
+    }
+
+    auto length_normal = [&](const Vec2f& vector, Vec2f& normal) -> float
+    {
+        if(Globals::fast_math != false) {
+            return ::fast_length_normal(vector, normal);
+        }
+        return ::length_normal(vector, normal);
+    };
+
     auto process = [&](const Pos2f& A, const Pos2f& B, const Pos2f& C, const float R) -> void
     {
         const Vec2f AB(B - A);
@@ -153,15 +275,21 @@ void Ball::collide(const Poly& poly)
             if((t >= 0.0f) && (t <= 1.0f)) {
                 const Pos2f P(A + (AB * t));
                 const Vec2f PC(C - P);
-                const float PC_length = (length(PC) + epsilon);
-                if(PC_length <= R) {
-                    const Vec2f normal(normalize(PC));
-                    const Vec2f ball_velocity(_velocity);
-                    const Vec2f poly_velocity(perpendicular(P - poly.position()) * poly.omega());
-                    const Vec2f relative_velocity(ball_velocity - poly_velocity);
-                    if(dot(relative_velocity, normal) < 0.0f) {
-                        _velocity = reflect(relative_velocity, normal) + poly_velocity ;
-                        _position += (normal * (R - PC_length));
+                if(length_squared(PC) <= (R * R)) {
+                    Vec2f normal;
+                    const float PC_length = (length_normal(PC, normal) + epsilon);
+                    if(PC_length <= R) {
+                        const Vec2f ball_velocity(_velocity);
+                        const Vec2f poly_velocity(perpendicular(P - poly.position()) * poly.omega());
+                        const Vec2f relative_velocity(ball_velocity - poly_velocity);
+                        const float speed = -dot(relative_velocity, normal);
+                        if(speed > 0.0f) {
+                            _velocity = reflect(relative_velocity, normal) + poly_velocity ;
+                            _position += (normal * (R - PC_length));
+                            if(contacts != nullptr) {
+                                contacts->push_back(Contact{P, normal, speed});
+                            }
+                        }
                     }
                 }
             }
@@ -180,6 +308,61 @@ void Ball::collide(const Poly& poly)
     return do_collide();
 }
 
+auto Ball::collide_fixed(const Poly& poly, Contacts* contacts) -> void
+{
+    const Fixed   epsilon(std::numeric_limits<float>::epsilon());
+    const Pos2x   poly_position(poly.position());
+    const Fixed   poly_omega(poly.omega());
+    Pos2x         position(_position);
+    Vec2x         velocity(_velocity);
+
+    auto process = [&](const Pos2x& A, const Pos2x& B, const Pos2x& C, const Fixed& R) -> void
+    {
+        const Vec2x AB(B - A);
+        const Vec2x AC(C - A);
+        const Fixed AB2 = dot(AB, AB);
+
+        if(AB2.raw != 0) {
+            const Fixed t = (dot(AC, AB) / AB2);
+            if((t.raw >= 0) && (t.raw <= Fixed::raw_one)) {
+                const Pos2x P(A + (AB * t));
+                const Vec2x PC(C - P);
+                if(dot(PC, PC) <= (R * R)) {
+                    Vec2x normal;
+                    const Fixed PC_length = (length_normal(PC, normal) + epsilon);
+                    if(PC_length <= R) {
+                        const Vec2x ball_velocity(velocity);
+                        const Vec2x poly_velocity(perpendicular(P - poly_position) * poly_omega);
+                        const Vec2x relative_velocity(ball_velocity - poly_velocity);
+                        const Fixed speed = -dot(relative_velocity, normal);
+                        if(speed.raw > 0) {
+                            velocity = reflect(relative_velocity, normal) + poly_velocity ;
+                            position += (normal * (R - PC_length));
+                            if(contacts != nullptr) {
+                                contacts->push_back(Contact{P.to_float(), normal.to_float(), speed.to_float()});
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    auto do_collide = [&]() -> void
+    {
+        const Fixed  radius(_radius);
+        const Pos2f* prev(&(*poly.rbegin()));
+        for(auto& vertex : poly) {
+            process(Pos2x(*prev), Pos2x(vertex), position, radius);
+            prev = &vertex;
+        }
+        _position = position.to_float();
+        _velocity = velocity.to_float();
+    };
+
+    return do_collide();
+}
+
 // ---------------------------------------------------------------------------
 // End-Of-File
 // ---------------------------------------------------------------------------
@@ -19,9 +19,27 @@
 
 #include "geometry.h"
 #include "canvas.h"
+#include "arena.h"
+
+// ---------------------------------------------------------------------------
+// Contact
+// ---------------------------------------------------------------------------
+
+struct Contact
+{
+    Pos2f position;
+    Vec2f normal;
+    float speed;
+};
+
+using Contacts = ArenaArray<Contact>;
 
 // ---------------------------------------------------------------------------
 // Object
+//
+// state shared by all the kinds of objects. There is no virtual interface:
+// the objects are stored by value in the typed batches of the World, which
+// runs each pass as a loop over a single concrete type.
 // ---------------------------------------------------------------------------
 
 class Object
@@ -31,13 +49,16 @@ public: // public interface
 
     Object(const Object&) = delete;
 
+    Object(Object&&) = default;
+
     Object& operator=(const Object&) = delete;
 
-    virtual ~Object() = default;
+    Object& operator=(Object&&) = default;
 
-    virtual auto update(const float dt) -> void = 0;
+    ~Object() = default;
 
-    virtual auto render(Canvas& canvas) -> void = 0;
+protected: // protected interface
+    auto assign(const Object& object) -> void;
 
 public: // public accessors
     auto position() const -> const Pos2f&
@@ -122,13 +143,19 @@ public: // public interface
 
     Poly(const Poly&) = delete;
 
+    Poly(Poly&&) = default;
+
     Poly& operator=(const Poly&) = delete;
 
-    virtual ~Poly() = default;
+    Poly& operator=(Poly&&) = default;
 
-    virtual auto update(const float dt) -> void override final;
+    ~Poly() = default;
 
-    virtual auto render(Canvas& canvas) -> void override final;
+    auto update(const float dt) -> void;
+
+    auto render(Canvas& canvas, const Vec2f& offset) -> void;
+
+    auto assign(const Poly& poly) -> void;
 
 public: // public accessors
     auto radius() const -> float
@@ -146,6 +173,11 @@ public: // public accessors
         return _angle;
     }
 
+    auto size() const -> int
+    {
+        return _vertices.size();
+    }
+
 public: // public mutators
     auto set_radius(float radius) -> void
     {
@@ -162,6 +194,11 @@ public: // public mutators
         _angle = angle;
     }
 
+    auto set_vertices(int vertices) -> void
+    {
+        _vertices.resize(vertices);
+    }
+
 public: // public iterators
     auto begin() const -> auto
     {
@@ -183,6 +220,10 @@ public: // public iterators
         return _vertices.rend();
     }
 
+private: // private interface
+    /* fixed-point step round-tripped through the float state, see Fixed */
+    auto update_fixed(const float dt) -> void;
+
 private: // private data
     std::vector<Pos2f> _vertices;
     float              _radius;
@@ -202,15 +243,21 @@ public: // public interface
 
     Ball(const Ball&) = delete;
 
+    Ball(Ball&&) = default;
+
     Ball& operator=(const Ball&) = delete;
 
-    virtual ~Ball() = default;
+    Ball& operator=(Ball&&) = default;
+
+    ~Ball() = default;
+
+    auto update(const float dt) -> void;
 
-    virtual auto update(const float dt) -> void override final;
+    auto render(Canvas& canvas, const Vec2f& offset) -> void;
 
-    virtual auto render(Canvas& canvas) -> void override final;
+    auto collide(const Poly& poly, Contacts* contacts = nullptr) -> void;
 
-    auto collide(const Poly& poly) -> void;
+    auto assign(const Ball& ball) -> void;
 
 public: // public accessors
     auto radius() const -> float
@@ -224,6 +271,12 @@ public: // public mutators
         _radius = radius;
     }
 
+private: // private interface
+    /* fixed-point step round-tripped through the float state, see Fixed */
+    auto update_fixed(const float dt) -> void;
+
+    auto collide_fixed(const Poly& poly, Contacts* contacts) -> void;
+
 private: // private data
     float _radius;
 };
@@ -0,0 +1,258 @@
+/*
+ * particles.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "globals.h"
+#include "particles.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::ParticleType
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct ParticleType
+{
+    static constexpr uint8_t SPARK = 0;
+    static constexpr uint8_t DUST  = 1;
+    static constexpr uint8_t COUNT = 2;
+};
+
+constexpr int   lane_count     = 8;
+constexpr int   fade_levels    = 4;
+constexpr int   batch_count    = (ParticleType::COUNT * fade_levels);
+constexpr float emit_threshold = 250.0f;
+constexpr float particle_drag  = 2.0f;
+
+}
+
+// ---------------------------------------------------------------------------
+// Particles
+// ---------------------------------------------------------------------------
+
+Particles::Particles(int capacity)
+    : _pos_x()
+    , _pos_y()
+    , _vel_x()
+    , _vel_y()
+    , _age()
+    , _life()
+    , _kind()
+    , _size(0)
+    , _capacity(capacity)
+    , _high_water(0)
+    , _dropped(0)
+    , _seed(UINT32_C(2463534242))
+    , _density(1.0f)
+{
+    const int padded = ((capacity + (lane_count - 1)) / lane_count) * lane_count;
+
+    _pos_x.resize(padded, 0.0f);
+    _pos_y.resize(padded, 0.0f);
+    _vel_x.resize(padded, 0.0f);
+    _vel_y.resize(padded, 0.0f);
+    _age.resize(padded, 0.0f);
+    _life.resize(padded, 0.0f);
+    _kind.resize(padded, 0);
+}
+
+auto Particles::clear() -> void
+{
+    _size = 0;
+}
+
+auto Particles::random() -> float
+{
+    _seed ^= (_seed << 13);
+    _seed ^= (_seed >> 17);
+    _seed ^= (_seed <<  5);
+
+    return float(_seed >> 8) * (1.0f / 16777216.0f);
+}
+
+auto Particles::spawn(const Pos2f& position, const Vec2f& velocity, float life, uint8_t kind) -> void
+{
+    if(_size >= _capacity) {
+        ++_dropped;
+        return;
+    }
+    const int index = _size++;
+    _pos_x[index] = position.x;
+    _pos_y[index] = position.y;
+    _vel_x[index] = velocity.x;
+    _vel_y[index] = velocity.y;
+    _age[index]   = 0.0f;
+    _life[index]  = life;
+    _kind[index]  = kind;
+    if(_high_water < _size) {
+        _high_water = _size;
+    }
+}
+
+auto Particles::emit(const Contact& contact) -> void
+{
+    if((contact.speed < emit_threshold) || (_density <= 0.0f)) {
+        return;
+    }
+    const Vec2f normal(contact.normal);
+    const Vec2f tangent(perpendicular(normal));
+    const int   sparks = std::max(1, int(_density * float(std::min(16, 2 + int(contact.speed / 100.0f)))));
+    const int   dusts  = std::max(1, int(_density * float(std::min(4, 1 + int(contact.speed / 400.0f)))));
+
+    for(int count = 0; count < sparks; ++count) {
+        const float spread = (2.0f * random()) - 1.0f;
+        const float speed  = contact.speed * (0.25f + (0.50f * random()));
+        const float life   = 0.15f + (0.25f * random());
+        spawn(contact.position, (normal + (tangent * spread)) * speed, life, ParticleType::SPARK);
+    }
+    for(int count = 0; count < dusts; ++count) {
+        const float spread = (2.0f * random()) - 1.0f;
+        const float speed  = 40.0f * random();
+        const float life   = 0.40f + (0.60f * random());
+        spawn(contact.position, (normal + (tangent * spread)) * speed, life, ParticleType::DUST);
+    }
+}
+
+auto Particles::update(const float dt, const Vec2f& gravity) -> void
+{
+    auto integrate = [&]() -> void
+    {
+        const Vec2fx8 acceleration(gravity * dt);
+        const float   damping = std::max(0.0f, 1.0f - (particle_drag * dt));
+        for(int index = 0; index < _size; index += lane_count) {
+            Pos2fx8 position(Pos2fx8::load(&_pos_x[index], &_pos_y[index]));
+            Vec2fx8 velocity(Vec2fx8::load(&_vel_x[index], &_vel_y[index]));
+            velocity = (velocity + acceleration) * damping;
+            position = position + (velocity * dt);
+            position.store(&_pos_x[index], &_pos_y[index]);
+            velocity.store(&_vel_x[index], &_vel_y[index]);
+        }
+    };
+
+    auto compact = [&]() -> void
+    {
+        int index = 0;
+        while(index < _size) {
+            if((_age[index] += dt) < _life[index]) {
+                ++index;
+                continue;
+            }
+            const int last = --_size;
+            _pos_x[index] = _pos_x[last];
+            _pos_y[index] = _pos_y[last];
+            _vel_x[index] = _vel_x[last];
+            _vel_y[index] = _vel_y[last];
+            _age[index]   = _age[last];
+            _life[index]  = _life[last];
+            _kind[index]  = _kind[last];
+        }
+    };
+
+    integrate();
+    compact();
+}
+
+auto Particles::render(Canvas& canvas, Arena& arena) -> void
+{
+    static const Col4i colors[ParticleType::COUNT] = {
+        Col4i(1.00f, 0.85f, 0.40f),
+        Col4i(0.70f, 0.70f, 0.70f),
+    };
+    static const int sizes[ParticleType::COUNT] = { 2, 3 };
+
+    if(_size == 0) {
+        return;
+    }
+
+    int   offsets[batch_count + 1] = {};
+    auto  rects = arena.allocate<RectType>(_size);
+    auto* batch = arena.allocate<uint8_t>(_size);
+
+    auto classify = [&]() -> void
+    {
+        for(int index = 0; index < _size; ++index) {
+            const int fade = std::min(fade_levels - 1, int((_age[index] / _life[index]) * float(fade_levels)));
+            batch[index] = uint8_t((_kind[index] * fade_levels) + fade);
+            ++offsets[batch[index] + 1];
+        }
+        for(int index = 0; index < batch_count; ++index) {
+            offsets[index + 1] += offsets[index];
+        }
+    };
+
+    auto scatter = [&]() -> void
+    {
+        int cursor[batch_count];
+        for(int index = 0; index < batch_count; ++index) {
+            cursor[index] = offsets[index];
+        }
+        for(int index = 0; index < _size; ++index) {
+            const int size = sizes[_kind[index]];
+            auto&     rect = rects[cursor[batch[index]]++];
+            rect.x = int(_pos_x[index]) - (size / 2);
+            rect.y = int(_pos_y[index]) - (size / 2);
+            rect.w = size;
+            rect.h = size;
+        }
+    };
+
+    auto draw = [&]() -> void
+    {
+        for(int index = 0; index < batch_count; ++index) {
+            const int count = (offsets[index + 1] - offsets[index]);
+            if(count == 0) {
+                continue;
+            }
+            Col4i color(colors[index / fade_levels]);
+            color.a = uint8_t(255 - ((255 * (index % fade_levels)) / fade_levels));
+            canvas.color(color);
+            canvas.fill_rects(&rects[offsets[index]], count);
+        }
+    };
+
+    classify();
+    scatter();
+    draw();
+}
+
+auto Particles::set_density(float density) -> void
+{
+    _density = std::max(0.0f, std::min(1.0f, density));
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+/*
+ * particles.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Particles_h__
+#define __Particles_h__
+
+#include "objects.h"
+
+// ---------------------------------------------------------------------------
+// Particles
+//
+// fixed-capacity pool of short-lived particles stored as structure of
+// arrays. Dead particles are removed by swapping in the last live one, so
+// that the live particles always stay packed at the front of the arrays.
+// ---------------------------------------------------------------------------
+
+class Particles
+{
+public: // public interface
+    Particles(int capacity);
+
+    Particles(const Particles&) = delete;
+
+    Particles& operator=(const Particles&) = delete;
+
+    virtual ~Particles() = default;
+
+    auto clear() -> void;
+
+    auto emit(const Contact& contact) -> void;
+
+    auto update(const float dt, const Vec2f& gravity) -> void;
+
+    auto render(Canvas& canvas, Arena& arena) -> void;
+
+    auto set_density(float density) -> void;
+
+public: // public accessors
+    auto size() const -> int
+    {
+        return _size;
+    }
+
+    auto capacity() const -> int
+    {
+        return _capacity;
+    }
+
+    auto high_water() const -> int
+    {
+        return _high_water;
+    }
+
+    auto dropped() const -> uint64_t
+    {
+        return _dropped;
+    }
+
+private: // private interface
+    auto spawn(const Pos2f& position, const Vec2f& velocity, float life, uint8_t kind) -> void;
+
+    auto random() -> float;
+
+private: // private data
+    std::vector<float>   _pos_x;
+    std::vector<float>   _pos_y;
+    std::vector<float>   _vel_x;
+    std::vector<float>   _vel_y;
+    std::vector<float>   _age;
+    std::vector<float>   _life;
+    std::vector<uint8_t> _kind;
+    int                  _size;
+    int                  _capacity;
+    int                  _high_water;
+    uint64_t             _dropped;
+    uint32_t             _seed;
+    float                _density;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Particles_h__ */
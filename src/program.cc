@@ -26,6 +26,7 @@
 #include <cmath>
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -36,6 +37,8 @@
 #endif
 #include "globals.h"
 #include "program.h"
+#include "benchmark.h"
+#include "selftest.h"
 #include "bouncing-ball.h"
 
 // ---------------------------------------------------------------------------
@@ -47,19 +50,149 @@ auto Program::init(const ArgList& args) -> bool
     static const std::locale new_locale("");
     static const std::locale old_locale(std::locale::global(new_locale));
 
+    auto get_value = [&](size_t& argi) -> const std::string&
+    {
+        if((argi + 1) >= args.size()) {
+            throw std::runtime_error(std::string("missing value for") + ' ' + '\'' + args[argi] + '\'');
+        }
+        return args[++argi];
+    };
+
+    auto get_int = [&](size_t& argi) -> int
+    {
+        const std::string& arg(args[argi]);
+        const std::string& val(get_value(argi));
+        char* end = nullptr;
+        const long value = ::strtol(val.c_str(), &end, 10);
+        if((val.empty() != false) || (*end != '\0')) {
+            throw std::runtime_error(std::string("invalid value for") + ' ' + '\'' + arg + '\'' + ' ' + '\'' + val + '\'');
+        }
+        return int(value);
+    };
+
+    auto get_float = [&](size_t& argi) -> float
+    {
+        const std::string& arg(args[argi]);
+        const std::string& val(get_value(argi));
+        char* end = nullptr;
+        const float value = ::strtof(val.c_str(), &end);
+        if((val.empty() != false) || (*end != '\0')) {
+            throw std::runtime_error(std::string("invalid value for") + ' ' + '\'' + arg + '\'' + ' ' + '\'' + val + '\'');
+        }
+        return value;
+    };
+
+    auto get_sched = [&](size_t& argi) -> int
+    {
+        const std::string& arg(args[argi]);
+        const std::string& val(get_value(argi));
+        if(val == "fifo") {
+            return SchedType::FIFO;
+        }
+        if(val == "rr") {
+            return SchedType::RR;
+        }
+        throw std::runtime_error(std::string("invalid value for") + ' ' + '\'' + arg + '\'' + ' ' + '\'' + val + '\'');
+    };
+
+    auto get_present = [&](size_t& argi) -> int
+    {
+        const std::string& arg(args[argi]);
+        const std::string& val(get_value(argi));
+        if(val == "vsync") {
+            return PresentType::VSYNC;
+        }
+        if(val == "immediate") {
+            return PresentType::IMMEDIATE;
+        }
+        if(val == "capped") {
+            return PresentType::CAPPED;
+        }
+        if(val == "latest") {
+            return PresentType::LATEST;
+        }
+        throw std::runtime_error(std::string("invalid value for") + ' ' + '\'' + arg + '\'' + ' ' + '\'' + val + '\'');
+    };
+
     auto do_parse = [&]() -> bool
     {
-        int argi = -1;
-        for(auto& arg : args) {
-            if(++argi == 0) {
-                continue;
-            }
-            else if(arg == "-h") {
+        for(size_t argi = 1; argi < args.size(); ++argi) {
+            const std::string& arg(args[argi]);
+            if(arg == "-h") {
                 return false;
             }
             else if(arg == "--help") {
                 return false;
             }
+            else if(arg == "--fast-math") {
+                Globals::set_fast_math(true);
+            }
+            else if(arg == "--fixed-point") {
+                Globals::set_fixed_point(true);
+            }
+            else if(arg == "--stats") {
+                Globals::set_stats(true);
+            }
+            else if(arg == "--alloc-assert") {
+                Globals::set_alloc_assert(true);
+            }
+            else if(arg == "--bench") {
+                Globals::set_benchmark(true);
+            }
+            else if(arg == "--selftest") {
+                Globals::set_selftest(true);
+            }
+            else if(arg == "--headless") {
+                Globals::set_headless(true);
+            }
+            else if(arg == "--steps") {
+                Globals::set_headless_steps(get_int(argi));
+            }
+            else if(arg == "--dt") {
+                Globals::set_headless_dtime(get_float(argi));
+            }
+            else if(arg == "--balls") {
+                Globals::set_ball_count(get_int(argi));
+            }
+            else if(arg == "--threaded") {
+                Globals::set_threaded(true);
+            }
+            else if(arg == "--pacing") {
+                Globals::set_pacing(get_int(argi));
+            }
+            else if(arg == "--no-idle") {
+                Globals::set_idle(false);
+            }
+            else if(arg == "--time-scale") {
+                Globals::set_time_scale(get_float(argi));
+            }
+            else if(arg == "--target-frame") {
+                Globals::set_target_frame(get_float(argi));
+            }
+            else if(arg == "--affinity") {
+                Globals::set_affinity(get_int(argi));
+            }
+            else if(arg == "--sched") {
+                Globals::set_sched_policy(get_sched(argi));
+            }
+            else if(arg == "--mlock") {
+                Globals::set_mlock(true);
+            }
+            else if(arg == "--prefault") {
+                Globals::set_prefault(true);
+            }
+            else if(arg == "--software") {
+                Globals::set_software(true);
+            }
+            else if(arg == "--full-redraw") {
+                Globals::set_dirty_rects(false);
+            }
+            else if(arg == "--present") {
+                Globals::set_present_mode(get_present(argi));
+            }
+            else if(arg == "--trail") {
+                Globals::set_trail_length(get_int(argi));
+            }
             else if(arg == "triangle") {
                 Globals::set_poly_vertices(PolygonType::TRIANGLE);
             }
@@ -149,6 +282,13 @@ auto Program::main(const ArgList& args) -> void
 #endif
     };
 
+    auto headless_loop = [&](std::ostream& stream) -> void
+    {
+        std::unique_ptr<BouncingBall> bouncing_ball(new BouncingBall(Globals::app_width, Globals::app_height));
+
+        return bouncing_ball->headless(stream);
+    };
+
     auto do_main = [&](std::ostream& stream) -> void
     {
         stream << "app_width" << " ....... " << Globals::app_width     << std::endl;
@@ -161,6 +301,31 @@ auto Program::main(const ArgList& args) -> void
         stream << "ball_radius" << " ..... " << Globals::ball_radius   << std::endl;
         stream << "ball_friction" << " ... " << Globals::ball_friction << std::endl;
         stream << "ball_gravity" << " .... " << Globals::ball_gravity  << std::endl;
+        stream << "fast_math" << " ....... " << Globals::fast_math     << std::endl;
+        stream << "fixed_point" << " ..... " << Globals::fixed_point   << std::endl;
+        stream << "ball_count" << " ...... " << Globals::ball_count    << std::endl;
+        stream << "threaded" << " ........ " << Globals::threaded      << std::endl;
+        stream << "pacing" << " .......... " << Globals::pacing        << std::endl;
+        stream << "idle" << " ............ " << Globals::idle          << std::endl;
+        stream << "time_scale" << " ...... " << Globals::time_scale    << std::endl;
+        stream << "target_frame" << " .... " << Globals::target_frame  << std::endl;
+        stream << "affinity" << " ........ " << Globals::affinity      << std::endl;
+        stream << "sched_policy" << " .... " << Globals::sched_policy  << std::endl;
+        stream << "mlock" << " ........... " << Globals::mlock         << std::endl;
+        stream << "prefault" << " ........ " << Globals::prefault      << std::endl;
+        stream << "software" << " ........ " << Globals::software      << std::endl;
+        stream << "dirty_rects" << " ..... " << Globals::dirty_rects   << std::endl;
+        stream << "present_mode" << " .... " << Globals::present_mode  << std::endl;
+        stream << "trail_length" << " .... " << Globals::trail_length  << std::endl;
+        if(Globals::benchmark != false) {
+            return Benchmark::run(stream);
+        }
+        if(Globals::selftest != false) {
+            return Selftest::run(stream);
+        }
+        if(Globals::headless != false) {
+            return headless_loop(stream);
+        }
         stream << "Pro tip: type <h> to display help"                  << std::endl;
 
         return main_loop();
@@ -188,6 +353,29 @@ auto Program::help(const ArgList& args) -> void
         stream << "Options:"                                                      << std::endl;
         stream << ""                                                              << std::endl;
         stream << "  -h, --help                    display this help and exit"    << std::endl;
+        stream << "  --fast-math                   use fast approximate geometry" << std::endl;
+        stream << "  --fixed-point                 use deterministic physics"     << std::endl;
+        stream << "  --stats                       print statistics every second" << std::endl;
+        stream << "  --alloc-assert                check zero-allocation frames"  << std::endl;
+        stream << "  --bench                       run the benchmarks and exit"   << std::endl;
+        stream << "  --selftest                    run the self-tests and exit"   << std::endl;
+        stream << "  --headless                    simulate without video/audio"  << std::endl;
+        stream << "  --steps N                     headless step count"           << std::endl;
+        stream << "  --dt SECONDS                  headless time step"            << std::endl;
+        stream << "  --balls M                     number of balls"               << std::endl;
+        stream << "  --threaded                    simulate on its own thread"    << std::endl;
+        stream << "  --pacing HZ                   pace frames to HZ (0 = off)"   << std::endl;
+        stream << "  --no-idle                     render even when at rest"      << std::endl;
+        stream << "  --time-scale X                time scale (0.1 to 1000)"      << std::endl;
+        stream << "  --target-frame MS             hold a frame time (0 = off)"   << std::endl;
+        stream << "  --affinity CPU                pin the simulation to a CPU"   << std::endl;
+        stream << "  --sched fifo|rr               real-time scheduling policy"   << std::endl;
+        stream << "  --mlock                       lock the memory after startup" << std::endl;
+        stream << "  --prefault                    prefault the arenas"           << std::endl;
+        stream << "  --software                    rasterize on the CPU"          << std::endl;
+        stream << "  --full-redraw                 redraw the whole frame"        << std::endl;
+        stream << "  --present MODE                vsync|immediate|capped|latest" << std::endl;
+        stream << "  --trail N                     ball trails of N positions"    << std::endl;
         stream << ""                                                              << std::endl;
         stream << "Shapes:"                                                       << std::endl;
         stream << ""                                                              << std::endl;
@@ -205,6 +393,13 @@ auto Program::help(const ArgList& args) -> void
         stream << ""                                                              << std::endl;
         stream << "h ................ toggle help overlay"                        << std::endl;
         stream << "u ................ toggle back underlay"                       << std::endl;
+        stream << "m ................ toggle occupancy heatmap"                   << std::endl;
+        stream << "l ................ print input latency"                        << std::endl;
+        stream << "p ................ cycle the present modes"                    << std::endl;
+        stream << "c ................ reset the camera"                           << std::endl;
+        stream << "+ ................ speed up the simulation"                     << std::endl;
+        stream << "- ................ slow down the simulation"                   << std::endl;
+        stream << "0 ................ restore the real-time speed"                << std::endl;
         stream << "r ................ reset simulation"                           << std::endl;
         stream << "q ................ quit the program"                           << std::endl;
         stream << "up ............... increase polygon vertices"                  << std::endl;
@@ -217,6 +412,8 @@ auto Program::help(const ArgList& args) -> void
         stream << "wheel ............ modify polygon radius"                      << std::endl;
         stream << "shift-button ..... modify ball position"                       << std::endl;
         stream << "shift-wheel ...... modify ball radius"                         << std::endl;
+        stream << "right-button ..... pan the camera"                             << std::endl;
+        stream << "ctrl-wheel ....... zoom the camera"                            << std::endl;
         stream << "escape ........... quit the program"                           << std::endl;
         stream << ""                                                              << std::endl;
     };
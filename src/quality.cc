@@ -0,0 +1,132 @@
+/*
+ * quality.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "globals.h"
+#include "quality.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::constants
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr float smoothing       = 0.05f;
+constexpr float degrade_ratio   = 1.10f;
+constexpr float improve_ratio   = 0.70f;
+constexpr int   degrade_frames  = 30;
+constexpr int   improve_frames  = 120;
+constexpr int   cooldown_frames = 60;
+
+}
+
+// ---------------------------------------------------------------------------
+// Quality
+// ---------------------------------------------------------------------------
+
+const QualityLevel Quality::levels[] = {
+    { 240, 2, 1, 1.00f, 1.00f },
+    { 240, 1, 1, 1.00f, 1.00f },
+    { 240, 1, 2, 0.50f, 1.00f },
+    { 120, 1, 4, 0.25f, 0.75f },
+    {  60, 1, 8, 0.00f, 0.50f },
+};
+
+const int Quality::level_count = int(sizeof(levels) / sizeof(levels[0]));
+
+const int Quality::default_level = 1;
+
+Quality::Quality(float target)
+    : _target(target)
+    , _average(0.0f)
+    , _index(default_level)
+    , _above(0)
+    , _below(0)
+    , _cooldown(0)
+{
+}
+
+/*
+ * feeds the time spent on a frame, in milliseconds, and returns true when
+ * the level has changed
+ */
+auto Quality::sample(float frame_time) -> bool
+{
+    const int index = _index;
+
+    auto change = [&](int next) -> void
+    {
+        std::cout << "quality: level " << _index << " -> " << next
+                  << " (frame " << _average << " ms, target " << _target << " ms)" << std::endl;
+        _index    = next;
+        _above    = 0;
+        _below    = 0;
+        _cooldown = cooldown_frames;
+    };
+
+    if(enabled() == false) {
+        return false;
+    }
+    if(_average <= 0.0f) {
+        _average = frame_time;
+    }
+    _average += ((frame_time - _average) * smoothing);
+    if(_cooldown > 0) {
+        --_cooldown;
+        return false;
+    }
+    _above = (_average > (_target * degrade_ratio) ? (_above + 1) : 0);
+    _below = (_average < (_target * improve_ratio) ? (_below + 1) : 0);
+    if((_above >= degrade_frames) && (_index < (level_count - 1))) {
+        change(_index + 1);
+    }
+    else if((_below >= improve_frames) && (_index > 0)) {
+        change(_index - 1);
+    }
+    return _index != index;
+}
+
+auto Quality::reset() -> void
+{
+    _average  = 0.0f;
+    _index    = default_level;
+    _above    = 0;
+    _below    = 0;
+    _cooldown = 0;
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,101 @@
+/*
+ * quality.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Quality_h__
+#define __Quality_h__
+
+// ---------------------------------------------------------------------------
+// QualityLevel
+//
+// settings traded against the frame time, from the finest to the coarsest:
+// the substep rate of the simulation in Hz, the collision passes per step,
+// the divisor of the segments of the circles, the fraction of particles
+// emitted and the scale of the internal render resolution.
+// ---------------------------------------------------------------------------
+
+struct QualityLevel
+{
+    int   substep_rate;
+    int   iterations;
+    int   circle_lod;
+    float particle_density;
+    float render_scale;
+};
+
+// ---------------------------------------------------------------------------
+// Quality
+//
+// controller that holds a target frame time by stepping through the quality
+// levels, with hysteresis: the average frame time has to stay above or below
+// the target for a while before the level changes, and every change is
+// followed by a cooldown so that the effect of a change is measured before
+// the next one.
+// ---------------------------------------------------------------------------
+
+class Quality
+{
+public: // public interface
+    Quality(float target);
+
+    Quality(const Quality&) = delete;
+
+    Quality& operator=(const Quality&) = delete;
+
+    virtual ~Quality() = default;
+
+    auto sample(float frame_time) -> bool;
+
+    auto reset() -> void;
+
+public: // public accessors
+    auto enabled() const -> bool
+    {
+        return _target > 0.0f;
+    }
+
+    auto index() const -> int
+    {
+        return _index;
+    }
+
+    auto level() const -> const QualityLevel&
+    {
+        return levels[_index];
+    }
+
+    auto average() const -> float
+    {
+        return _average;
+    }
+
+private: // private data
+    static const QualityLevel levels[];
+    static const int          level_count;
+    static const int          default_level;
+
+    float _target;
+    float _average;
+    int   _index;
+    int   _above;
+    int   _below;
+    int   _cooldown;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Quality_h__ */
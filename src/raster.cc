@@ -0,0 +1,742 @@
+/*
+ * raster.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "geometry.h"
+#include "realtime.h"
+#include "raster.h"
+
+// ---------------------------------------------------------------------------
+// the vector lanes of the pixels are passed by value between the helpers,
+// the template instances being emitted at the end of this translation unit
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// ---------------------------------------------------------------------------
+// <anonymous>::constants
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int tile_size       = 64;
+constexpr int tile_pixels     = (tile_size * tile_size);
+constexpr int lane_padding    = 8;
+constexpr int max_threads     = 8;
+constexpr int primitive_tiles = 4;
+
+}
+
+// ---------------------------------------------------------------------------
+// <anonymous>::pixels
+// ---------------------------------------------------------------------------
+
+namespace {
+
+/*
+ * the canvas packs its colors as RGBA, the framebuffer is ARGB
+ */
+auto to_argb(uint32_t rgba) -> uint32_t
+{
+    return (rgba >> 8) | (rgba << 24);
+}
+
+/*
+ * 8-bit alpha to the 0..256 range of the blending, so that 255 is opaque
+ */
+auto to_weight(uint32_t alpha) -> uint32_t
+{
+    return alpha + (alpha >> 7);
+}
+
+/*
+ * the red and blue channels are blended together and the green one apart,
+ * so that a 32-bit product never overflows into the next channel
+ */
+auto blend(uint32_t src, uint32_t dst, uint32_t weight) -> uint32_t
+{
+    const uint32_t inverse = (256 - weight);
+    const uint32_t rb      = ((((src & 0x00ff00ff) * weight) + ((dst & 0x00ff00ff) * inverse)) >> 8) & 0x00ff00ff;
+    const uint32_t g       = ((((src & 0x0000ff00) * weight) + ((dst & 0x0000ff00) * inverse)) >> 8) & 0x0000ff00;
+
+    return 0xff000000 | rb | g;
+}
+
+/*
+ * the vector versions work on 16-bit lanes, a channel times a weight never
+ * exceeding 16 bits, so that the products are plain 16-bit multiplications
+ */
+template <typename Pixel, typename Half>
+auto blend_lanes(const Pixel& src, const Pixel& dst, const Pixel& weight) -> Pixel
+{
+    const Half factor  = Half(weight | (weight << 16));
+    const Half inverse = (256 - factor);
+    const Half rb      = (((Half(src & 0x00ff00ff) * factor) + (Half(dst & 0x00ff00ff) * inverse)) >> 8);
+    const Half ag      = (((Half((src >> 8) & 0x00ff00ff) * factor) + (Half((dst >> 8) & 0x00ff00ff) * inverse)) >> 8);
+
+    return 0xff000000 | Pixel(rb) | (Pixel(ag) << 8);
+}
+
+auto blend(const Pixelx8& src, const Pixelx8& dst, const Pixelx8& weight) -> Pixelx8
+{
+    return blend_lanes<Pixelx8, Halfx16>(src, dst, weight);
+}
+
+auto blend(const Pixelx4& src, const Pixelx4& dst, const Pixelx4& weight) -> Pixelx4
+{
+    return blend_lanes<Pixelx4, Halfx8>(src, dst, weight);
+}
+
+template <typename Pixel>
+auto load(const uint32_t* pixels) -> Pixel
+{
+    Pixel vector;
+    ::memcpy(&vector, pixels, sizeof(vector));
+    return vector;
+}
+
+template <typename Pixel>
+auto store(uint32_t* pixels, const Pixel& vector) -> void
+{
+    ::memcpy(pixels, &vector, sizeof(vector));
+}
+
+/*
+ * fills [x0, x1) of a row with a color of the given weight, eight pixels at
+ * a time and the remainder one by one
+ */
+auto span(uint32_t* row, int x0, int x1, uint32_t color, uint32_t weight) -> void
+{
+    if((x0 >= x1) || (weight == 0)) {
+        return;
+    }
+    if(weight >= 256) {
+        std::fill(row + x0, row + x1, (color | 0xff000000));
+        return;
+    }
+    const Pixelx8 src    = (Pixelx8{} + color);
+    const Pixelx8 factor = (Pixelx8{} + weight);
+    int x = x0;
+    for(; (x + 8) <= x1; x += 8) {
+        store(row + x, blend(src, load<Pixelx8>(row + x), factor));
+    }
+    for(; x < x1; ++x) {
+        row[x] = blend(color, row[x], weight);
+    }
+}
+
+/*
+ * square root of four squared distances, with the bit-level guess of the
+ * reciprocal square root refined by a single Newton-Raphson step, which is
+ * well below a 1/256 of coverage over the reach of a tile
+ */
+auto distance(const Floatx4& length2) -> Floatx4
+{
+    Maskx4  bits;
+    Floatx4 guess;
+
+    ::memcpy(&bits, &length2, sizeof(bits));
+    bits = (0x5f375a86 - Maskx4(Pixelx4(bits) >> 1));
+    ::memcpy(&guess, &bits, sizeof(guess));
+    guess *= (1.5f - (0.5f * length2 * guess * guess));
+    return (length2 * guess);
+}
+
+/*
+ * blends a color over [x0, x1) of a row with the coverage of the pixels,
+ * evaluated four at a time from the centers of the pixels. The lanes past
+ * the end get no coverage, which leaves their opaque pixels unchanged, so
+ * that the rows only need a few pixels of padding.
+ */
+template <typename Coverage>
+auto cover(uint32_t* row, int x0, int x1, uint32_t color, uint32_t weight, Coverage&& coverage) -> void
+{
+    const Floatx4 centers = { 0.5f, 1.5f, 2.5f, 3.5f };
+    const Floatx4 zero    = (Floatx4{} + 0.0f);
+    const Floatx4 one     = (Floatx4{} + 1.0f);
+    const Pixelx4 src     = (Pixelx4{} + color);
+
+    for(int x = x0; x < x1; x += 4) {
+        Floatx4 amount = coverage(centers + float(x));
+        amount = Lanes<4>::select((amount < zero), zero, amount);
+        amount = Lanes<4>::select((amount > one),  one,  amount);
+        amount = Lanes<4>::select((centers < float(x1 - x)), amount, zero);
+        const Pixelx4 factor = Pixelx4(__builtin_convertvector((amount * float(weight)), Maskx4));
+        store(row + x, blend(src, load<Pixelx4>(row + x), factor));
+    }
+}
+
+/*
+ * blends a row of ARGB pixels over a row, each with its own alpha
+ */
+auto compose(uint32_t* row, const uint32_t* src, int count) -> void
+{
+    int x = 0;
+    for(; (x + 8) <= count; x += 8) {
+        const Pixelx8 pixels = load<Pixelx8>(src + x);
+        const Pixelx8 alpha  = (pixels >> 24);
+        store(row + x, blend(pixels, load<Pixelx8>(row + x), (alpha + (alpha >> 7))));
+    }
+    for(; x < count; ++x) {
+        row[x] = blend(src[x], row[x], to_weight(src[x] >> 24));
+    }
+}
+
+/*
+ * nearest-neighbor resampling of an image to the framebuffer size
+ */
+auto resample(const RasterImage& source, RasterImage& target, int width, int height) -> void
+{
+    target.width  = width;
+    target.height = height;
+    target.pixels.clear();
+    if((source.width <= 0) || (source.height <= 0)) {
+        return;
+    }
+    target.pixels.resize(size_t(width) * size_t(height));
+    uint32_t* pixel = target.pixels.data();
+    for(int y = 0; y < height; ++y) {
+        const uint32_t* row = &source.pixels[size_t((y * source.height) / height) * size_t(source.width)];
+        for(int x = 0; x < width; ++x) {
+            *pixel++ = row[(x * source.width) / width];
+        }
+    }
+}
+
+auto copy(const SurfaceType* surface, RasterImage& image) -> void
+{
+    image.pixels.clear();
+    image.width  = 0;
+    image.height = 0;
+    if(surface == nullptr) {
+        return;
+    }
+    image.width  = surface->w;
+    image.height = surface->h;
+    image.pixels.resize(size_t(surface->w) * size_t(surface->h));
+    for(int y = 0; y < surface->h; ++y) {
+        ::memcpy(&image.pixels[size_t(y) * size_t(surface->w)], (static_cast<const uint8_t*>(surface->pixels) + (y * surface->pitch)), (surface->w * sizeof(uint32_t)));
+    }
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Raster
+// ---------------------------------------------------------------------------
+
+Raster::Raster(int threads)
+    : _underlay_source()
+    , _overlay_source()
+    , _underlay()
+    , _overlay()
+    , _primitives()
+    , _tile_first()
+    , _tile_items()
+    , _tile_fill()
+    , _width(0)
+    , _height(0)
+    , _tiles_x(0)
+    , _tiles_y(0)
+    , _scene(nullptr)
+    , _pixels(nullptr)
+    , _pitch(0)
+    , _workers()
+    , _mutex()
+    , _start()
+    , _finish()
+    , _generation(0)
+    , _busy(0)
+    , _quit(false)
+    , _next(0)
+{
+#ifdef __EMSCRIPTEN__
+    threads = 1;
+#endif
+    threads = std::max(1, std::min(max_threads, threads));
+    for(int index = 1; index < threads; ++index) {
+        _workers.emplace_back([this]() { run_worker(); });
+    }
+}
+
+Raster::~Raster()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _start.notify_all();
+    for(auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+auto Raster::set_underlay(const SurfaceType* surface) -> void
+{
+    copy(surface, _underlay_source);
+    resample(_underlay_source, _underlay, _width, _height);
+}
+
+auto Raster::set_overlay(const SurfaceType* surface) -> void
+{
+    copy(surface, _overlay_source);
+    resample(_overlay_source, _overlay, _width, _height);
+}
+
+/*
+ * sizes the buffers for the largest expected frame, a primitive usually
+ * covering a few tiles at most
+ */
+auto Raster::reserve(int primitives) -> void
+{
+    _primitives.reserve(primitives);
+    _tile_items.reserve(primitives * primitive_tiles);
+}
+
+auto Raster::render(const RasterScene& scene, uint32_t* pixels, int pitch, int width, int height) -> void
+{
+    if((width <= 0) || (height <= 0)) {
+        return;
+    }
+    if((width != _width) || (height != _height)) {
+        resize(width, height);
+    }
+    _scene  = &scene;
+    _pixels = pixels;
+    _pitch  = pitch;
+    convert(scene);
+    bin();
+    draw_tiles();
+    _scene  = nullptr;
+    _pixels = nullptr;
+}
+
+auto Raster::resize(int width, int height) -> void
+{
+    _width   = width;
+    _height  = height;
+    _tiles_x = ((width  + tile_size - 1) / tile_size);
+    _tiles_y = ((height + tile_size - 1) / tile_size);
+    _tile_first.assign((tiles() + 1), 0);
+    _tile_fill.assign(tiles(), 0);
+    resample(_underlay_source, _underlay, width, height);
+    resample(_overlay_source, _overlay, width, height);
+}
+
+/*
+ * turns the recorded commands into primitives in pixel coordinates, in the
+ * order of the commands, so that the tiles draw them in the same order
+ */
+auto Raster::convert(const RasterScene& scene) -> void
+{
+    const float scale = scene.scale;
+
+    auto add = [&](int type, uint32_t color, float x0, float y0, float x1, float y1, float x2) -> void
+    {
+        _primitives.push_back(RasterPrimitive{type, color, (x0 * scale), (y0 * scale), (x1 * scale), (y1 * scale), x2});
+    };
+
+    auto add_shapes = [&](const DrawCommand& command, uint32_t color) -> void
+    {
+        for(int index = 0; index < command.count; ++index) {
+            const Shape& shape(scene.shapes[command.first + index]);
+            if(command.type == DrawType::LINES) {
+                add(DrawType::LINES, color, shape.x1, shape.y1, shape.x2, shape.y2, std::max(0.5f, (shape.radius * scale)));
+            }
+            else {
+                add(DrawType::DISCS, color, shape.x1, shape.y1, shape.radius, 0.0f, 0.0f);
+            }
+        }
+    };
+
+    auto add_sprites = [&](const DrawCommand& command, uint32_t color) -> void
+    {
+        for(int index = 0; (index + 5) < command.count; index += 6) {
+            const SDL_FPoint& p0(scene.vertices[scene.indices[command.first + index + 0]].position);
+            const SDL_FPoint& p2(scene.vertices[scene.indices[command.first + index + 2]].position);
+            const float       radius = ((0.5f * (p2.x - p0.x)) - 1.0f);
+            add(DrawType::DISCS, color, (0.5f * (p0.x + p2.x)), (0.5f * (p0.y + p2.y)), radius, 0.0f, 0.0f);
+        }
+    };
+
+    /*
+     * every quad of a trail becomes a capsule along its middle, of its
+     * half-width and of the alpha of its older end
+     */
+    auto add_trails = [&](const DrawCommand& command, uint32_t color) -> void
+    {
+        for(int index = 0; (index + 5) < command.count; index += 6) {
+            const VertexType& a0(scene.vertices[scene.indices[command.first + index + 0]]);
+            const VertexType& b0(scene.vertices[scene.indices[command.first + index + 1]]);
+            const VertexType& b1(scene.vertices[scene.indices[command.first + index + 2]]);
+            const VertexType& a1(scene.vertices[scene.indices[command.first + index + 5]]);
+            const float       dx     = (a0.position.x - a1.position.x);
+            const float       dy     = (a0.position.y - a1.position.y);
+            const float       radius = std::max(0.5f, (0.5f * ::sqrtf((dx * dx) + (dy * dy)) * scale));
+            const uint32_t    faded  = ((color & 0x00ffffff) | (uint32_t(a0.color.a) << 24));
+            add(DrawType::LINES, faded, (0.5f * (a0.position.x + a1.position.x)), (0.5f * (a0.position.y + a1.position.y)), (0.5f * (b0.position.x + b1.position.x)), (0.5f * (b0.position.y + b1.position.y)), radius);
+        }
+    };
+
+    auto add_rects = [&](const DrawCommand& command, uint32_t color) -> void
+    {
+        for(int index = 0; index < command.count; ++index) {
+            const RectType& rect(scene.rects[command.first + index]);
+            add(DrawType::RECTS, color, float(rect.x), float(rect.y), float(rect.x + rect.w), float(rect.y + rect.h), 0.0f);
+        }
+    };
+
+    _primitives.clear();
+    for(int index = 0; index < scene.count; ++index) {
+        const DrawCommand& command(scene.commands[index]);
+        const uint32_t     color = to_argb(command.color);
+        switch(command.type) {
+            case DrawType::LINES:
+            case DrawType::DISCS:
+                add_shapes(command, color);
+                break;
+            case DrawType::TRAILS:
+                add_trails(command, color);
+                break;
+            case DrawType::SPRITES:
+                add_sprites(command, color);
+                break;
+            case DrawType::RECTS:
+                add_rects(command, color);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * counting sort of the primitives into the tiles their bounds overlap: the
+ * first pass counts the items of each tile, the second one stores them
+ */
+auto Raster::bin() -> void
+{
+    auto bounds = [&](const RasterPrimitive& primitive, int& tx0, int& ty0, int& tx1, int& ty1) -> bool
+    {
+        float x0, y0, x1, y1;
+        if(primitive.type == DrawType::DISCS) {
+            x0 = (primitive.x0 - primitive.x1 - 1.0f);
+            y0 = (primitive.y0 - primitive.x1 - 1.0f);
+            x1 = (primitive.x0 + primitive.x1 + 1.0f);
+            y1 = (primitive.y0 + primitive.x1 + 1.0f);
+        }
+        else if(primitive.type == DrawType::LINES) {
+            x0 = (std::min(primitive.x0, primitive.x1) - primitive.x2 - 1.0f);
+            y0 = (std::min(primitive.y0, primitive.y1) - primitive.x2 - 1.0f);
+            x1 = (std::max(primitive.x0, primitive.x1) + primitive.x2 + 1.0f);
+            y1 = (std::max(primitive.y0, primitive.y1) + primitive.x2 + 1.0f);
+        }
+        else {
+            x0 = primitive.x0;
+            y0 = primitive.y0;
+            x1 = primitive.x1;
+            y1 = primitive.y1;
+        }
+        if((x1 < 0.0f) || (y1 < 0.0f) || (x0 >= float(_width)) || (y0 >= float(_height))) {
+            return false;
+        }
+        tx0 = (int(std::max(0.0f, x0)) / tile_size);
+        ty0 = (int(std::max(0.0f, y0)) / tile_size);
+        tx1 = (int(std::min(float(_width  - 1), x1)) / tile_size);
+        ty1 = (int(std::min(float(_height - 1), y1)) / tile_size);
+        return true;
+    };
+
+    std::fill(_tile_first.begin(), _tile_first.end(), 0);
+    int tx0, ty0, tx1, ty1;
+    for(auto& primitive : _primitives) {
+        if(bounds(primitive, tx0, ty0, tx1, ty1) != false) {
+            for(int ty = ty0; ty <= ty1; ++ty) {
+                for(int tx = tx0; tx <= tx1; ++tx) {
+                    ++_tile_first[(ty * _tiles_x) + tx + 1];
+                }
+            }
+        }
+    }
+    for(int tile = 0; tile < tiles(); ++tile) {
+        _tile_first[tile + 1] += _tile_first[tile];
+        _tile_fill[tile] = _tile_first[tile];
+    }
+    _tile_items.resize(_tile_first[tiles()]);
+    int index = 0;
+    for(auto& primitive : _primitives) {
+        if(bounds(primitive, tx0, ty0, tx1, ty1) != false) {
+            for(int ty = ty0; ty <= ty1; ++ty) {
+                for(int tx = tx0; tx <= tx1; ++tx) {
+                    _tile_items[_tile_fill[(ty * _tiles_x) + tx]++] = index;
+                }
+            }
+        }
+        ++index;
+    }
+}
+
+/*
+ * the calling thread draws tiles along with the workers, each one taking
+ * the next tile until none is left
+ */
+auto Raster::draw_tiles() -> void
+{
+    uint32_t buffer[tile_pixels + lane_padding];
+
+    auto draw_all = [&]() -> void
+    {
+        for(int tile = _next.fetch_add(1); tile < tiles(); tile = _next.fetch_add(1)) {
+            draw_tile(tile, buffer);
+        }
+    };
+
+    _next = 0;
+    if(_workers.empty() != false) {
+        return draw_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _busy = int(_workers.size());
+        ++_generation;
+    }
+    _start.notify_all();
+    draw_all();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finish.wait(lock, [&]() { return _busy == 0; });
+}
+
+auto Raster::run_worker() -> void
+{
+    uint32_t buffer[tile_pixels + lane_padding];
+    uint64_t generation = 0;
+
+    Realtime::setup_thread("a raster worker");
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start.wait(lock, [&]() { return (_quit != false) || (_generation != generation); });
+            if(_quit != false) {
+                return;
+            }
+            generation = _generation;
+        }
+        for(int tile = _next.fetch_add(1); tile < tiles(); tile = _next.fetch_add(1)) {
+            draw_tile(tile, buffer);
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_busy;
+        }
+        _finish.notify_one();
+    }
+}
+
+/*
+ * draws the background, the binned primitives and the overlay of a tile in
+ * its buffer, then copies the rows to the framebuffer
+ */
+auto Raster::draw_tile(int tile, uint32_t* buffer) -> void
+{
+    const RasterScene& scene(*_scene);
+    const int          left   = ((tile % _tiles_x) * tile_size);
+    const int          top    = ((tile / _tiles_x) * tile_size);
+    const int          width  = std::min(tile_size, (_width  - left));
+    const int          height = std::min(tile_size, (_height - top));
+    const int          right  = (left + width);
+    const int          bottom = (top  + height);
+
+    auto row = [&](int y) -> uint32_t*
+    {
+        return &buffer[(y - top) * tile_size] - left;
+    };
+
+    auto draw_background = [&]() -> void
+    {
+        const bool underlay = ((scene.underlay != false) && (_underlay.pixels.empty() == false));
+        for(int y = top; y < bottom; ++y) {
+            span(row(y), left, right, to_argb(scene.background), 256);
+            if(underlay != false) {
+                compose(&row(y)[left], &_underlay.pixels[(size_t(y) * size_t(_width)) + left], width);
+            }
+        }
+    };
+
+    auto draw_overlay = [&]() -> void
+    {
+        if((scene.overlay != false) && (_overlay.pixels.empty() == false)) {
+            for(int y = top; y < bottom; ++y) {
+                compose(&row(y)[left], &_overlay.pixels[(size_t(y) * size_t(_width)) + left], width);
+            }
+        }
+    };
+
+    /*
+     * the rows of the capsule are bounded by the part of the segment within
+     * reach of the row, then every pixel gets the coverage given by its
+     * distance to the segment
+     */
+    auto draw_capsule = [&](const RasterPrimitive& primitive, uint32_t weight) -> void
+    {
+        const float dx      = (primitive.x1 - primitive.x0);
+        const float dy      = (primitive.y1 - primitive.y0);
+        const float length2 = ((dx * dx) + (dy * dy));
+        const float inverse = (length2 > 0.0f ? (1.0f / length2) : 0.0f);
+        const float outer   = (primitive.x2 + 0.5f);
+        const float reach   = (outer + 1.0f);
+        const int   y0      = std::max(top,    int(::floorf(std::min(primitive.y0, primitive.y1) - reach)));
+        const int   y1      = std::min(bottom, int(::ceilf(std::max(primitive.y0, primitive.y1) + reach)));
+        for(int py = y0; py < y1; ++py) {
+            const float cy = (float(py) + 0.5f);
+            float       t0 = 0.0f;
+            float       t1 = 1.0f;
+            if(dy != 0.0f) {
+                const float ta = ((cy - reach - primitive.y0) / dy);
+                const float tb = ((cy + reach - primitive.y0) / dy);
+                t0 = std::max(t0, std::min(ta, tb));
+                t1 = std::min(t1, std::max(ta, tb));
+            }
+            if(t0 > t1) {
+                continue;
+            }
+            const float xa = (primitive.x0 + (t0 * dx));
+            const float xb = (primitive.x0 + (t1 * dx));
+            const int   x0 = std::max(left,  int(::floorf(std::min(xa, xb) - reach)));
+            const int   x1 = std::min(right, int(::ceilf(std::max(xa, xb) + reach)));
+            const float py0 = (cy - primitive.y0);
+            cover(row(py), x0, x1, primitive.color, weight, [&](const Floatx4& px) -> Floatx4
+            {
+                const Floatx4 px0 = (px - primitive.x0);
+                Floatx4       t   = (((px0 * dx) + (py0 * dy)) * inverse);
+                t = Lanes<4>::select((t < 0.0f), (Floatx4{} + 0.0f), t);
+                t = Lanes<4>::select((t > 1.0f), (Floatx4{} + 1.0f), t);
+                const Floatx4 ex = (px0 - (t * dx));
+                const Floatx4 ey = (py0 - (t * dy));
+                return (outer - distance((ex * ex) + (ey * ey)));
+            });
+        }
+    };
+
+    /*
+     * the inner span of every row is solid, the pixels along the edge get
+     * the coverage given by their distance to the center
+     */
+    auto draw_disc = [&](const RasterPrimitive& primitive, uint32_t weight) -> void
+    {
+        const float xc    = primitive.x0;
+        const float yc    = primitive.y0;
+        const float outer = (primitive.x1 + 0.5f);
+        const float inner = std::max(0.0f, (primitive.x1 - 0.5f));
+        const int   y0    = std::max(top,    int(::floorf(yc - outer)));
+        const int   y1    = std::min(bottom, int(::ceilf(yc + outer)));
+        for(int py = y0; py < y1; ++py) {
+            const float dy  = (float(py) + 0.5f - yc);
+            const float dy2 = (dy * dy);
+            if(dy2 >= (outer * outer)) {
+                continue;
+            }
+            const float     wo   = ::sqrtf((outer * outer) - dy2);
+            const float     wi   = (dy2 < (inner * inner) ? ::sqrtf((inner * inner) - dy2) : -1.0f);
+            const int       x0   = std::max(left,  int(::floorf(xc - wo)));
+            const int       x1   = std::min(right, int(::ceilf(xc + wo)));
+            const int       xi0  = std::min(x1, std::max(x0, int(::ceilf(xc - wi - 0.5f))));
+            const int       xi1  = std::max(xi0, std::min(x1, (int(::floorf(xc + wi - 0.5f)) + 1)));
+            uint32_t* const line = row(py);
+            auto edge = [&](const Floatx4& px) -> Floatx4
+            {
+                const Floatx4 dx = (px - xc);
+                return (outer - distance((dx * dx) + dy2));
+            };
+            cover(line, x0, xi0, primitive.color, weight, edge);
+            span(line, xi0, xi1, primitive.color, weight);
+            cover(line, xi1, x1, primitive.color, weight, edge);
+        }
+    };
+
+    auto draw_rect = [&](const RasterPrimitive& primitive, uint32_t weight) -> void
+    {
+        const int x0 = std::max(left,   int(primitive.x0));
+        const int y0 = std::max(top,    int(primitive.y0));
+        const int x1 = std::min(right,  int(primitive.x1));
+        const int y1 = std::min(bottom, int(primitive.y1));
+        for(int py = y0; py < y1; ++py) {
+            span(row(py), x0, x1, primitive.color, weight);
+        }
+    };
+
+    auto draw_primitives = [&]() -> void
+    {
+        for(int item = _tile_first[tile]; item < _tile_first[tile + 1]; ++item) {
+            const RasterPrimitive& primitive(_primitives[_tile_items[item]]);
+            const uint32_t         weight = to_weight(primitive.color >> 24);
+            switch(primitive.type) {
+                case DrawType::LINES:
+                    draw_capsule(primitive, weight);
+                    break;
+                case DrawType::DISCS:
+                    draw_disc(primitive, weight);
+                    break;
+                case DrawType::RECTS:
+                    draw_rect(primitive, weight);
+                    break;
+                default:
+                    break;
+            }
+        }
+    };
+
+    auto copy_rows = [&]() -> void
+    {
+        for(int y = top; y < bottom; ++y) {
+            uint32_t* target = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(_pixels) + (y * _pitch)) + left;
+            ::memcpy(target, &row(y)[left], (width * sizeof(uint32_t)));
+        }
+    };
+
+    draw_background();
+    draw_primitives();
+    draw_overlay();
+    copy_rows();
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+/*
+ * raster.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Raster_h__
+#define __Raster_h__
+
+#include "canvas.h"
+
+// ---------------------------------------------------------------------------
+// Pixelx8/Pixelx4
+//
+// packed ARGB pixels, as 32-bit lanes or as 16-bit lanes of two channels
+// each. The solid spans are filled eight pixels at once, the anti-aliased
+// edges, which are usually a few pixels long, four pixels at once.
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef uint32_t Pixelx8 __attribute__((vector_size(8 * sizeof(uint32_t))));
+typedef uint16_t Halfx16 __attribute__((vector_size(16 * sizeof(uint16_t))));
+typedef uint32_t Pixelx4 __attribute__((vector_size(4 * sizeof(uint32_t))));
+typedef uint16_t Halfx8  __attribute__((vector_size(8 * sizeof(uint16_t))));
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// ---------------------------------------------------------------------------
+// RasterScene
+//
+// recorded frame handed over to the rasterizer: the sorted commands and the
+// buffers they refer to, the background color, whether the underlay
+// and the overlay are shown, and the scale from canvas to pixel coordinates.
+// ---------------------------------------------------------------------------
+
+struct RasterScene
+{
+    const DrawCommand* commands;
+    int                count;
+    const Shape*       shapes;
+    const VertexType*  vertices;
+    const int*         indices;
+    const RectType*    rects;
+    uint32_t           background;
+    bool               underlay;
+    bool               overlay;
+    float              scale;
+};
+
+// ---------------------------------------------------------------------------
+// RasterPrimitive
+//
+// primitive in pixel coordinates: a capsule from (x0, y0) to (x1, y1) of
+// radius x2, a disc of center (x0, y0) and radius x1, or a rectangle from
+// (x0, y0) to (x1, y1).
+// ---------------------------------------------------------------------------
+
+struct RasterPrimitive
+{
+    int      type;
+    uint32_t color;
+    float    x0;
+    float    y0;
+    float    x1;
+    float    y1;
+    float    x2;
+};
+
+// ---------------------------------------------------------------------------
+// RasterImage
+// ---------------------------------------------------------------------------
+
+struct RasterImage
+{
+    std::vector<uint32_t> pixels;
+    int                   width  = 0;
+    int                   height = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Raster
+//
+// software rasterizer into a CPU framebuffer. The primitives are binned into
+// 64x64 tiles, then every tile is drawn into a small buffer that stays in
+// the cache of the thread that owns it: background or underlay first, then
+// the primitives in order, then the overlay, and finally the rows are copied
+// to the target, which is usually the locked pixels of a streaming texture.
+// The tiles are shared between the calling thread and a pool of workers.
+// ---------------------------------------------------------------------------
+
+class Raster
+{
+public: // public interface
+    Raster(int threads);
+
+    Raster(const Raster&) = delete;
+
+    Raster& operator=(const Raster&) = delete;
+
+    virtual ~Raster();
+
+    auto set_underlay(const SurfaceType* surface) -> void;
+
+    auto set_overlay(const SurfaceType* surface) -> void;
+
+    auto reserve(int primitives) -> void;
+
+    auto render(const RasterScene& scene, uint32_t* pixels, int pitch, int width, int height) -> void;
+
+public: // public accessors
+    auto threads() const -> int
+    {
+        return int(_workers.size()) + 1;
+    }
+
+    auto tiles() const -> int
+    {
+        return _tiles_x * _tiles_y;
+    }
+
+private: // private interface
+    auto resize(int width, int height) -> void;
+
+    auto convert(const RasterScene& scene) -> void;
+
+    auto bin() -> void;
+
+    auto draw_tiles() -> void;
+
+    auto draw_tile(int tile, uint32_t* buffer) -> void;
+
+    auto run_worker() -> void;
+
+private: // private data
+    RasterImage                  _underlay_source;
+    RasterImage                  _overlay_source;
+    RasterImage                  _underlay;
+    RasterImage                  _overlay;
+    std::vector<RasterPrimitive> _primitives;
+    std::vector<int>             _tile_first;
+    std::vector<int>             _tile_items;
+    std::vector<int>             _tile_fill;
+    int                          _width;
+    int                          _height;
+    int                          _tiles_x;
+    int                          _tiles_y;
+    const RasterScene*           _scene;
+    uint32_t*                    _pixels;
+    int                          _pitch;
+    std::vector<std::thread>     _workers;
+    std::mutex                   _mutex;
+    std::condition_variable      _start;
+    std::condition_variable      _finish;
+    uint64_t                     _generation;
+    int                          _busy;
+    bool                         _quit;
+    std::atomic<int>             _next;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Raster_h__ */
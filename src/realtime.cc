@@ -0,0 +1,132 @@
+/*
+ * realtime.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+#include "globals.h"
+#include "realtime.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::warning
+// ---------------------------------------------------------------------------
+
+namespace {
+
+auto warning(const char* what, const char* name) -> void
+{
+    std::cerr << "realtime: unable to " << what << ' ' << name << " (" << ::strerror(errno) << ')' << std::endl;
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Realtime
+// ---------------------------------------------------------------------------
+
+/*
+ * applies the requested affinity and scheduling policy to the calling thread
+ */
+auto Realtime::setup_thread(const char* name) -> void
+{
+    if(Globals::affinity >= 0) {
+        if(pin_thread(Globals::affinity) == false) {
+            warning("pin", name);
+        }
+    }
+    if(Globals::sched_policy != SchedType::OTHER) {
+        if(set_policy(Globals::sched_policy) == false) {
+            warning("raise the priority of", name);
+        }
+    }
+}
+
+/*
+ * locks the pages mapped so far in memory, the future mappings are left
+ * alone so that a low memlock limit does not make the later allocations fail
+ */
+auto Realtime::lock_memory() -> void
+{
+    if(Globals::mlock != false) {
+#ifdef __linux__
+        const int rc = ::mlockall(MCL_CURRENT);
+#else
+        const int rc = (errno = ENOSYS, -1);
+#endif
+        if(rc != 0) {
+            warning("lock the memory of", "the process");
+        }
+    }
+}
+
+auto Realtime::pin_thread(int cpu) -> bool
+{
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    const int rc = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+    if(rc != 0) {
+        errno = rc;
+    }
+    return rc == 0;
+#else
+    return (errno = ENOSYS, false);
+#endif
+}
+
+auto Realtime::set_policy(int policy) -> bool
+{
+#ifdef __linux__
+    const int   native = (policy == SchedType::FIFO ? SCHED_FIFO : SCHED_RR);
+    sched_param param;
+    ::memset(&param, 0, sizeof(param));
+    param.sched_priority = ((::sched_get_priority_min(native) + ::sched_get_priority_max(native)) / 2);
+    const int rc = ::pthread_setschedparam(::pthread_self(), native, &param);
+    if(rc != 0) {
+        errno = rc;
+    }
+    return rc == 0;
+#else
+    return (errno = ENOSYS, false);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
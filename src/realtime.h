@@ -0,0 +1,43 @@
+/*
+ * realtime.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Realtime_h__
+#define __Realtime_h__
+
+// ---------------------------------------------------------------------------
+// Realtime
+//
+// opt-in scheduling and memory settings. Each of them may be refused by the
+// system, typically without the matching privileges, in which case a warning
+// is printed and the program goes on with the default behavior.
+// ---------------------------------------------------------------------------
+
+struct Realtime
+{
+    static auto setup_thread(const char* name) -> void;
+
+    static auto lock_memory() -> void;
+
+    static auto pin_thread(int cpu) -> bool;
+
+    static auto set_policy(int policy) -> bool;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Realtime_h__ */
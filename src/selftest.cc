@@ -0,0 +1,297 @@
+/*
+ * selftest.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include "geometry.h"
+#include "selftest.h"
+
+// ---------------------------------------------------------------------------
+// the lanes are passed by value to the checks instantiated in this file
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// ---------------------------------------------------------------------------
+// <anonymous>::Checker
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int   samples   = 1000;
+constexpr int   reports   = 16;
+constexpr float tolerance = 1e-4f;
+constexpr float range     = 8.0f;
+
+struct Checker
+{
+    Checker(std::ostream& stream, const char* suite)
+        : stream(stream)
+        , suite(suite)
+        , checks(0)
+        , failures(0)
+    {
+    }
+
+    auto expect(const char* what, int lane, float actual, float expected) -> void
+    {
+        ++checks;
+        if(::fabsf(actual - expected) <= (tolerance * std::max(1.0f, ::fabsf(expected)))) {
+            return;
+        }
+        if(failures++ < reports) {
+            stream << suite << '/' << what << " lane " << lane << " ... " << actual << " != " << expected << std::endl;
+        }
+    }
+
+    auto expect(const char* what, int lane, const Pos2f& actual, const Pos2f& expected) -> void
+    {
+        expect(what, lane, actual.x, expected.x);
+        expect(what, lane, actual.y, expected.y);
+    }
+
+    auto expect(const char* what, int lane, const Vec2f& actual, const Vec2f& expected) -> void
+    {
+        expect(what, lane, actual.x, expected.x);
+        expect(what, lane, actual.y, expected.y);
+    }
+
+    auto summary() const -> int
+    {
+        stream << suite << " ... " << (checks - failures) << '/' << checks << " passed" << std::endl;
+        return failures;
+    }
+
+    std::ostream& stream;
+    const char*   suite;
+    int           checks;
+    int           failures;
+};
+
+struct Random
+{
+    Random(uint32_t seed)
+        : state(seed)
+    {
+    }
+
+    auto next() -> float
+    {
+        state ^= (state << 13);
+        state ^= (state >> 17);
+        state ^= (state <<  5);
+        return range * ((float(state >> 8) / float(1 << 23)) - 1.0f);
+    }
+
+    uint32_t state;
+};
+
+/*
+ * every lane of the N-wide types must match the scalar Pos2f/Vec2f
+ * operation applied to the same inputs, lane 0 of 'b' being forced to
+ * zero so that the zero-length normalize branch is exercised as well
+ */
+
+template <int N>
+auto check_lanes(Checker& checker, Random& random) -> void
+{
+    using Float = typename Lanes<N>::Float;
+    using Mask  = typename Lanes<N>::Mask;
+
+    float px[N], py[N];
+    float ax[N], ay[N];
+    float bx[N], by[N];
+    float cs[N];
+    Float scale;
+
+    for(int lane = 0; lane < N; ++lane) {
+        px[lane] = random.next();
+        py[lane] = random.next();
+        ax[lane] = random.next();
+        ay[lane] = random.next();
+        bx[lane] = (lane != 0 ? random.next() : 0.0f);
+        by[lane] = (lane != 0 ? random.next() : 0.0f);
+        cs[lane] = 1.0f + ::fabsf(random.next());
+        scale[lane] = cs[lane];
+    }
+
+    const Pos2fxN<N> p(Pos2fxN<N>::load(px, py));
+    const Pos2fxN<N> q(Pos2fxN<N>::load(ax, ay));
+    const Vec2fxN<N> a(Vec2fxN<N>::load(ax, ay));
+    const Vec2fxN<N> b(Vec2fxN<N>::load(bx, by));
+    const Vec2fxN<N> c(scale, scale);
+    const Vec2fxN<N> n(normalize(a));
+    const Mask       mask(a.x > b.x);
+
+    auto check_ops = [&](const int lane) -> void
+    {
+        const Pos2f P(px[lane], py[lane]);
+        const Pos2f Q(ax[lane], ay[lane]);
+        const Vec2f A(ax[lane], ay[lane]);
+        const Vec2f B(bx[lane], by[lane]);
+        const Vec2f C(cs[lane], cs[lane]);
+        const Vec2f M(normalize(A));
+        const float S(cs[lane]);
+
+        checker.expect("pos+vec", lane, (p + a).lane(lane), (P + A));
+        checker.expect("pos-vec", lane, (p - a).lane(lane), (P - A));
+        checker.expect("pos*vec", lane, (p * a).lane(lane), (P * A));
+        checker.expect("pos/vec", lane, (p / c).lane(lane), (P / C));
+        checker.expect("pos-pos", lane, (p - q).lane(lane), (P - Q));
+        checker.expect("vec+vec", lane, (a + b).lane(lane), (A + B));
+        checker.expect("vec-vec", lane, (a - b).lane(lane), (A - B));
+        checker.expect("vec*vec", lane, (a * b).lane(lane), (A * B));
+        checker.expect("vec/vec", lane, (a / c).lane(lane), (A / C));
+        checker.expect("vec*lanes", lane, (a * scale).lane(lane), (A * S));
+        checker.expect("vec/lanes", lane, (a / scale).lane(lane), (A / S));
+        checker.expect("vec*float", lane, (a * 1.5f).lane(lane), (A * 1.5f));
+        checker.expect("vec/float", lane, (a / 1.5f).lane(lane), (A / 1.5f));
+        checker.expect("dot", lane, dot(a, b)[lane], dot(A, B));
+        checker.expect("length", lane, length(a)[lane], length(A));
+        checker.expect("normalize", lane, n.lane(lane), M);
+        checker.expect("normalize/zero", lane, normalize(b).lane(lane), normalize(B));
+        checker.expect("perpendicular", lane, perpendicular(a).lane(lane), perpendicular(A));
+        checker.expect("reflect", lane, reflect(b, n).lane(lane), reflect(B, M));
+        checker.expect("select", lane, select<N>(mask, a, b).lane(lane), (A.x > B.x ? A : B));
+    };
+
+    auto check_assign = [&](const int lane) -> void
+    {
+        Pos2fxN<N> pp(p);
+        Vec2fxN<N> aa(a);
+        Pos2f      P(px[lane], py[lane]);
+        Vec2f      A(ax[lane], ay[lane]);
+        const Vec2f B(bx[lane], by[lane]);
+        const Vec2f C(cs[lane], cs[lane]);
+        const float S(cs[lane]);
+
+        pp += a; P += A; checker.expect("pos+=vec", lane, pp.lane(lane), P);
+        pp -= b; P -= B; checker.expect("pos-=vec", lane, pp.lane(lane), P);
+        pp *= a; P *= A; checker.expect("pos*=vec", lane, pp.lane(lane), P);
+        pp /= c; P /= C; checker.expect("pos/=vec", lane, pp.lane(lane), P);
+        aa += b; A += B; checker.expect("vec+=vec", lane, aa.lane(lane), A);
+        aa -= c; A -= C; checker.expect("vec-=vec", lane, aa.lane(lane), A);
+        aa *= b; A *= B; checker.expect("vec*=vec", lane, aa.lane(lane), A);
+        aa /= c; A /= C; checker.expect("vec/=vec", lane, aa.lane(lane), A);
+        aa *= scale; A *= S; checker.expect("vec*=lanes", lane, aa.lane(lane), A);
+        aa /= scale; A /= S; checker.expect("vec/=lanes", lane, aa.lane(lane), A);
+        aa *= 1.5f; A *= 1.5f; checker.expect("vec*=float", lane, aa.lane(lane), A);
+        aa /= 1.5f; A /= 1.5f; checker.expect("vec/=float", lane, aa.lane(lane), A);
+    };
+
+    auto check_reductions = [&]() -> void
+    {
+        Vec2f sum;
+        float min = ax[0];
+        float max = ax[0];
+        bool  any = false;
+        bool  all = true;
+        for(int lane = 0; lane < N; ++lane) {
+            sum += Vec2f(ax[lane], ay[lane]);
+            min  = std::min(min, ax[lane]);
+            max  = std::max(max, ax[lane]);
+            any  = (any || (ax[lane] > bx[lane]));
+            all  = (all && (ax[lane] > bx[lane]));
+        }
+        checker.expect("reduce_add", -1, reduce_add(a), sum);
+        checker.expect("reduce_min", -1, Lanes<N>::reduce_min(a.x), min);
+        checker.expect("reduce_max", -1, Lanes<N>::reduce_max(a.x), max);
+        checker.expect("any", -1, float(Lanes<N>::any(mask)), float(any));
+        checker.expect("all", -1, float(Lanes<N>::all(mask)), float(all));
+    };
+
+    auto check_memory = [&]() -> void
+    {
+        for(int count = 1; count <= N; ++count) {
+            float xs[N + 1], ys[N + 1];
+            std::fill(xs, xs + N + 1, -1.0f);
+            std::fill(ys, ys + N + 1, -1.0f);
+            const Vec2fxN<N> partial(Vec2fxN<N>::load(ax, ay, count));
+            partial.store(xs, ys, count);
+            for(int lane = 0; lane <= N; ++lane) {
+                const Vec2f expected(lane < count ? Vec2f(ax[lane], ay[lane]) : Vec2f(-1.0f, -1.0f));
+                checker.expect("load/store", lane, Vec2f(xs[lane], ys[lane]), expected);
+                if(lane < N) {
+                    const Vec2f loaded(lane < count ? Vec2f(ax[lane], ay[lane]) : Vec2f(0.0f, 0.0f));
+                    checker.expect("load/partial", lane, partial.lane(lane), loaded);
+                }
+            }
+        }
+        float xs[N], ys[N];
+        p.store(xs, ys);
+        for(int lane = 0; lane < N; ++lane) {
+            checker.expect("store", lane, Pos2f(xs[lane], ys[lane]), Pos2f(px[lane], py[lane]));
+        }
+    };
+
+    auto do_check = [&]() -> void
+    {
+        for(int lane = 0; lane < N; ++lane) {
+            check_ops(lane);
+            check_assign(lane);
+        }
+        check_reductions();
+        check_memory();
+    };
+
+    return do_check();
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Selftest
+// ---------------------------------------------------------------------------
+
+auto Selftest::run(std::ostream& stream) -> void
+{
+    int failures = 0;
+
+    failures += lanes(stream);
+
+    if(failures != 0) {
+        throw std::runtime_error("the self-tests have failed");
+    }
+}
+
+auto Selftest::lanes(std::ostream& stream) -> int
+{
+    Checker x4(stream, "lanes/x4");
+    Checker x8(stream, "lanes/x8");
+    Random  random(0x9e3779b9u);
+
+    for(int sample = 0; sample < samples; ++sample) {
+        check_lanes<4>(x4, random);
+        check_lanes<8>(x8, random);
+    }
+    return x4.summary() + x8.summary();
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,159 @@
+/*
+ * trails.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "globals.h"
+#include "trails.h"
+
+// ---------------------------------------------------------------------------
+// <anonymous>::constants
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr float still_epsilon = 0.01f;
+
+}
+
+// ---------------------------------------------------------------------------
+// Trails
+// ---------------------------------------------------------------------------
+
+Trails::Trails(int length, int balls)
+    : _pos_x()
+    , _pos_y()
+    , _length(length)
+    , _balls(0)
+    , _head(0)
+    , _count(0)
+    , _still(0)
+    , _time(0)
+    , _frames(0)
+{
+    resize(balls);
+}
+
+auto Trails::clear() -> void
+{
+    _head  = 0;
+    _count = 0;
+    _still = 0;
+}
+
+/*
+ * sizes the rings for the given number of balls and empties them, the
+ * storage only growing when there are more balls than ever before
+ */
+auto Trails::resize(int balls) -> void
+{
+    const size_t size = (size_t(balls) * size_t(_length));
+
+    _pos_x.resize(size, 0.0f);
+    _pos_y.resize(size, 0.0f);
+    _balls = balls;
+    clear();
+}
+
+/*
+ * writes the position of every ball at the head of its ring, the oldest one
+ * being overwritten once the ring is full, and counts the frames in a row
+ * during which no ball has moved
+ */
+auto Trails::record(const World& world) -> void
+{
+    const auto& balls(world.balls());
+    bool        moved = (_count == 0);
+
+    if(int(balls.size()) != _balls) {
+        resize(int(balls.size()));
+    }
+    const int previous = ((_head + _length - 1) % _length);
+    for(int ball = 0; ball < _balls; ++ball) {
+        const Pos2f& position(balls[ball].position());
+        float* const pos_x = &_pos_x[size_t(ball) * size_t(_length)];
+        float* const pos_y = &_pos_y[size_t(ball) * size_t(_length)];
+        if((::fabsf(position.x - pos_x[previous]) >= still_epsilon)
+        || (::fabsf(position.y - pos_y[previous]) >= still_epsilon)) {
+            moved = true;
+        }
+        pos_x[_head] = position.x;
+        pos_y[_head] = position.y;
+    }
+    _head  = ((_head + 1) % _length);
+    _count = std::min(_length, (_count + 1));
+    _still = (moved != false ? 0 : (_still + 1));
+}
+
+/*
+ * records the current positions, then hands the ring of every ball over to
+ * the canvas, which batches all the trails into the same geometry
+ */
+auto Trails::render(Canvas& canvas, const World& world) -> void
+{
+    const uint64_t start = ::SDL_GetPerformanceCounter();
+
+    auto do_render = [&]() -> void
+    {
+        const int first = ((_head + _length - _count) % _length);
+        int       ball  = 0;
+        for(auto& object : world.balls()) {
+            const size_t offset = (size_t(ball++) * size_t(_length));
+            canvas.color(object.color());
+            canvas.trail(&_pos_x[offset], &_pos_y[offset], _length, first, _count, object.radius());
+        }
+    };
+
+    if(_length == 0) {
+        return;
+    }
+    record(world);
+    do_render();
+    _time += (::SDL_GetPerformanceCounter() - start);
+    ++_frames;
+}
+
+/*
+ * the trails are settled once no ball has moved for as many frames as the
+ * rings hold, so that they have shrunk into the balls
+ */
+auto Trails::settled() const -> bool
+{
+    return (_length == 0) || (_still >= _length);
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,102 @@
+/*
+ * trails.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __Trails_h__
+#define __Trails_h__
+
+#include "world.h"
+
+// ---------------------------------------------------------------------------
+// Trails
+//
+// ring buffers of the last positions of every ball, stored as structure of
+// arrays, the slots of a ball being contiguous. All the rings share the same
+// head, since a position of every ball is recorded at once for each frame.
+// The storage is sized once for the given number of balls, so that the
+// memory is length x balls pairs of floats.
+// ---------------------------------------------------------------------------
+
+class Trails
+{
+public: // public interface
+    Trails(int length, int balls);
+
+    Trails(const Trails&) = delete;
+
+    Trails& operator=(const Trails&) = delete;
+
+    virtual ~Trails() = default;
+
+    auto clear() -> void;
+
+    auto render(Canvas& canvas, const World& world) -> void;
+
+    auto settled() const -> bool;
+
+public: // public accessors
+    auto length() const -> int
+    {
+        return _length;
+    }
+
+    auto balls() const -> int
+    {
+        return _balls;
+    }
+
+    auto bytes() const -> size_t
+    {
+        return (_pos_x.capacity() + _pos_y.capacity()) * sizeof(float);
+    }
+
+    auto time() const -> uint64_t
+    {
+        return _time;
+    }
+
+    auto frames() const -> uint32_t
+    {
+        return _frames;
+    }
+
+    auto reset_time() -> void
+    {
+        _time   = 0;
+        _frames = 0;
+    }
+
+private: // private interface
+    auto resize(int balls) -> void;
+
+    auto record(const World& world) -> void;
+
+private: // private data
+    std::vector<float> _pos_x;
+    std::vector<float> _pos_y;
+    int                _length;
+    int                _balls;
+    int                _head;
+    int                _count;
+    int                _still;
+    uint64_t           _time;
+    uint32_t           _frames;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __Trails_h__ */
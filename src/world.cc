@@ -0,0 +1,135 @@
+/*
+ * world.cc - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+#include "globals.h"
+#include "world.h"
+
+// ---------------------------------------------------------------------------
+// World
+// ---------------------------------------------------------------------------
+
+World::World()
+    : _polys()
+    , _balls()
+{
+}
+
+/*
+ * copies the objects of another world, the batches are only resized when
+ * the counts differ so that the steady state does not allocate
+ */
+auto World::assign(const World& world) -> void
+{
+    while(_polys.size() < world._polys.size()) {
+        _polys.emplace_back(Pos2f(), 0, 0.0f);
+    }
+    if(_polys.size() > world._polys.size()) {
+        _polys.erase((_polys.begin() + world._polys.size()), _polys.end());
+    }
+    while(_balls.size() < world._balls.size()) {
+        _balls.emplace_back(Pos2f(), 0.0f);
+    }
+    if(_balls.size() > world._balls.size()) {
+        _balls.erase((_balls.begin() + world._balls.size()), _balls.end());
+    }
+    for(size_t index = 0; index < _polys.size(); ++index) {
+        _polys[index].assign(world._polys[index]);
+    }
+    for(size_t index = 0; index < _balls.size(); ++index) {
+        _balls[index].assign(world._balls[index]);
+    }
+}
+
+auto World::update(const float dt) -> void
+{
+    for(auto& poly : _polys) {
+        poly.update(dt);
+    }
+    for(auto& ball : _balls) {
+        ball.update(dt);
+    }
+}
+
+/*
+ * collides every ball with every poly, only the first of the iterations
+ * records its contacts
+ */
+auto World::collide(Contacts* contacts, int iterations) -> void
+{
+    for(auto& ball : _balls) {
+        for(auto& poly : _polys) {
+            ball.collide(poly, contacts);
+        }
+        for(int iteration = 1; iteration < iterations; ++iteration) {
+            for(auto& poly : _polys) {
+                ball.collide(poly);
+            }
+        }
+    }
+}
+
+/*
+ * the first poly and the first ball, those dragged with the mouse, are drawn
+ * shifted by the given offsets, the other objects where they are
+ */
+auto World::render(Canvas& canvas, const Vec2f& poly_offset, const Vec2f& ball_offset) -> void
+{
+    const Vec2f none;
+
+    for(auto& poly : _polys) {
+        poly.render(canvas, (&poly == _polys.data() ? poly_offset : none));
+    }
+    for(auto& ball : _balls) {
+        ball.render(canvas, (&ball == _balls.data() ? ball_offset : none));
+    }
+}
+
+/*
+ * upper bound of the contacts of a single step, one per edge and ball
+ */
+auto World::contact_capacity() const -> size_t
+{
+    size_t edges = 0;
+
+    for(auto& poly : _polys) {
+        edges += poly.size();
+    }
+    return edges * _balls.size();
+}
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+/*
+ * world.h - Copyright (c) 2024-2025 - Olivier Poncet
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __World_h__
+#define __World_h__
+
+#include "objects.h"
+
+// ---------------------------------------------------------------------------
+// World
+//
+// container of the objects of a scene, each kind of object being stored by
+// value in its own contiguous batch. The update, collide and render passes
+// are plain loops over a single concrete type, so that no call goes through
+// a virtual table and the objects of a pass are adjacent in memory.
+// ---------------------------------------------------------------------------
+
+class World
+{
+public: // public interface
+    World();
+
+    World(const World&) = delete;
+
+    World& operator=(const World&) = delete;
+
+    virtual ~World() = default;
+
+    auto assign(const World& world) -> void;
+
+    auto update(const float dt) -> void;
+
+    auto collide(Contacts* contacts, int iterations) -> void;
+
+    auto render(Canvas& canvas, const Vec2f& poly_offset, const Vec2f& ball_offset) -> void;
+
+    auto contact_capacity() const -> size_t;
+
+public: // public accessors
+    auto polys() -> std::vector<Poly>&
+    {
+        return _polys;
+    }
+
+    auto polys() const -> const std::vector<Poly>&
+    {
+        return _polys;
+    }
+
+    auto balls() -> std::vector<Ball>&
+    {
+        return _balls;
+    }
+
+    auto balls() const -> const std::vector<Ball>&
+    {
+        return _balls;
+    }
+
+private: // private data
+    std::vector<Poly> _polys;
+    std::vector<Ball> _balls;
+};
+
+// ---------------------------------------------------------------------------
+// End-Of-File
+// ---------------------------------------------------------------------------
+
+#endif /* __World_h__ */